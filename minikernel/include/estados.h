@@ -0,0 +1,39 @@
+/*
+ *  minikernel/include/estados.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera con los estados de un proceso que añade el kernel
+ * a los de const.h. Lo incluyen kernel.h y servicios.h para que
+ * foto_procesos() use los mismos valores en ambos lados.
+ *
+ */
+
+#ifndef _ESTADOS_H
+#define _ESTADOS_H
+
+#include "const.h"
+
+/*
+ *
+ * Estados adicionales de un proceso
+ *
+ */
+#define DORMIDO 4
+#define BLOQUEADO_MTX 5
+#define BLOQUEADO_TERM 6
+#define BLOQUEADO_PIPE_LEC 7
+#define BLOQUEADO_PIPE_ESC 8
+#define BLOQUEADO_COLA_REC 9
+#define BLOQUEADO_COLA_ENV 10
+#define ZOMBI 11
+#define BLOQUEADO_HIJO 12
+#define ESTRANGULADO 13
+
+#endif /* _ESTADOS_H */
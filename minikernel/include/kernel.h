@@ -19,6 +19,7 @@
 #define _KERNEL_H
 
 #include "const.h"
+#include "estados.h"
 #include "HAL.h"
 #include "llamsis.h"
 
@@ -47,6 +48,206 @@
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+/*
+ * Posibles estados de un pipe
+ */
+#define PIPE_NO_USADO 0		/* Entrada de tabla de pipes no usada */
+#define PIPE_USADO 1
+
+#define PIPE_DESC_NO_USADO -1	/* Entrada de la lista de descriptores de pipe de un proceso no usada */
+
+/*
+ * Errores asociados a un pipe
+ */
+#define PIPE_NAME_EXIST -1
+#define PIPE_NAME_LONG -2
+#define PIPE_MAX_DESC -3
+#define PIPE_TABLE_FULL -4
+#define PIPE_CLOSED -5
+#define PIPE_NO_EXIST -6
+#define PIPE_BAD_SIZE -7
+#define PIPE_WOULD_BLOCK -8
+#define PIPE_BROKEN -9
+#define PIPE_BAD_MODE -10
+#define PIPE_NO_MEMORY -11
+
+/* constantes con los modos de acceso a un pipe (se pueden combinar) */
+#define PIPE_BLOQUEANTE 0
+#define PIPE_NO_BLOQUEANTE 1
+#define PIPE_SOLO_LECTURA 2		/* el descriptor es un extremo de lectura */
+#define PIPE_SOLO_ESCRITURA 4	/* el descriptor es un extremo de escritura */
+#define PIPE_NO_HEREDAR 8		/* los hijos no heredan el descriptor */
+
+#define PIPE_LEE(modo) (((modo) & PIPE_SOLO_ESCRITURA) == 0)
+#define PIPE_ESCRIBE(modo) (((modo) & PIPE_SOLO_LECTURA) == 0)
+
+/* constantes usadas en implementacion de pipes */
+#define NUM_PIPES 8			/* numero total de pipes en el sistema */
+#define NUM_PIPE_PROC 4		/* numero maximo de pipes que puede tener abiertos un proceso */
+#define MAX_NOM_PIPE 8		/* longitud maxima de un nombre de pipe */
+#define TAM_MAX_PIPE 65536	/* tamaño maximo del buffer de un pipe */
+
+/*
+ * Posibles estados de una cola de mensajes
+ */
+#define COLA_NO_USADA 0		/* Entrada de tabla de colas no usada */
+#define COLA_USADA 1
+
+#define COLA_DESC_NO_USADO -1	/* Entrada de la lista de descriptores de cola de un proceso no usada */
+#define BUF_MSJ_NINGUNO -1		/* El mensaje viaja copiado en su celda del slab */
+
+/*
+ * Errores asociados a una cola de mensajes
+ */
+#define COLA_NAME_EXIST -1
+#define COLA_NAME_LONG -2
+#define COLA_MAX_DESC -3
+#define COLA_TABLE_FULL -4
+#define COLA_CLOSED -5
+#define COLA_NO_EXIST -6
+#define COLA_BAD_SIZE -7
+#define COLA_TIMEOUT -8
+#define COLA_SLAB_FULL -9
+#define COLA_BAD_BUFFER -10
+#define COLA_NO_MEMORY -11
+
+/* constante para esperar en una cola sin plazo */
+#define ESPERA_INDEFINIDA -1
+
+/* constantes usadas en implementacion de colas de mensajes */
+#define NUM_COLAS 8			/* numero total de colas en el sistema */
+#define NUM_COLA_PROC 4		/* numero maximo de colas que puede tener abiertas un proceso */
+#define MAX_NOM_COLA 8		/* longitud maxima de un nombre de cola */
+#define MAX_MSJ_COLA 32		/* numero maximo de mensajes encolados en una cola */
+#define NUM_MSJ_SLAB 128	/* numero de celdas de mensaje del slab del kernel */
+#define TAM_MSJ_PEQ 64		/* tamaño maximo de un mensaje que se copia en el slab */
+#define NUM_BUF_MSJ 32		/* numero maximo de buffers de mensajes grandes */
+#define TAM_MAX_MSJ 65536	/* tamaño maximo de un mensaje grande */
+
+/*
+ * Posibles estados de una region de memoria compartida
+ */
+#define SHM_NO_USADA 0		/* Entrada de tabla de regiones no usada */
+#define SHM_USADA 1
+
+#define SHM_DESC_NO_USADO -1	/* Entrada de la lista de descriptores de region de un proceso no usada */
+
+/*
+ * Errores asociados a una region de memoria compartida
+ */
+#define SHM_NAME_EXIST -1
+#define SHM_NAME_LONG -2
+#define SHM_MAX_DESC -3
+#define SHM_TABLE_FULL -4
+#define SHM_CLOSED -5
+#define SHM_NO_EXIST -6
+#define SHM_BAD_SIZE -7
+#define SHM_NO_MEMORY -8
+
+/* constantes usadas en implementacion de memoria compartida */
+#define NUM_SHM 8			/* numero total de regiones en el sistema */
+#define NUM_SHM_PROC 4		/* numero maximo de regiones que puede tener abiertas un proceso */
+#define MAX_NOM_SHM 8		/* longitud maxima de un nombre de region */
+#define TAM_MAX_SHM 1048576	/* tamaño maximo de una region */
+
+/* constantes usadas en implementacion de la cache de imagenes */
+#define NUM_IMAGENES 8		/* numero de imagenes que se mantienen residentes */
+#define MAX_NOM_PROG 32		/* longitud maxima del nombre de un programa en la cache */
+#define IMAGEN_NO_CACHEADA -1	/* imagen cargada fuera de la cache */
+
+/* constantes usadas en implementacion del pool de pilas */
+#define NUM_PILAS_INICIALES 4	/* pilas que se reservan en el arranque */
+#define MAX_PILAS_LIBRES 8		/* maximo de pilas libres que conserva el pool */
+
+/* constantes usadas en implementacion de la tabla de procesos */
+#define MAX_TABLA_PROCS 1024	/* dimension maxima de la tabla (MAX_PROC de const.h no se usa) */
+#define PROCS_POR_BLOQUE 16		/* BCPs que se reservan cada vez que crece la tabla */
+#define MAX_BLOQUES_PROC (MAX_TABLA_PROCS/PROCS_POR_BLOQUE)
+#define MAX_GENERACION (0x7fffffff/MAX_TABLA_PROCS)	/* usos distintos de una entrada antes de repetir id */
+#define TAM_ARGUMENTOS 128		/* longitud maxima (con el nulo) de los argumentos de un proceso */
+
+/* constantes usadas en implementacion de la espera por hijos */
+#define SIN_PADRE -1		/* proceso creado por el kernel (init) */
+#define CUALQUIER_HIJO -1	/* esperar_proceso espera al primer hijo que termine */
+#define FIN_POR_EXCEPCION -1	/* estado de fin de un proceso abortado por una excepcion */
+
+/* Errores de la espera por hijos */
+#define PROC_NO_CHILD -1
+#define PROC_NO_CHILDREN -2
+
+/* constantes usadas en implementacion de los procesos periodicos (EDF) */
+#define MAX_UTILIZACION 1000	/* suma maxima de costes/plazos admitida (en milesimas) */
+
+/* Errores de los procesos periodicos */
+#define TR_BAD_PARAM -1
+#define TR_ADMISSION -2
+#define TR_NOT_PERIODIC -3
+
+/* constantes usadas en implementacion del planificador CFS */
+#define NICE_MIN -20
+#define NICE_MAX 19
+#define PESO_NICE_0 1024		/* peso de un proceso con nice 0 */
+#define VR_POR_TICK 1024		/* vruntime que carga un tick a un proceso de nice 0 */
+#define GRANULARIDAD_MIN 2		/* ticks minimos de ejecucion antes de expulsar */
+#define BONO_DESPERTAR (3*VR_POR_TICK)	/* credito maximo que conserva un proceso que se bloqueo */
+
+/* Errores de fijar_nice */
+#define NICE_BAD_PARAM -1
+
+/* Errores de las cuotas de procesador */
+#define CUOTA_BAD_PARAM -1
+#define CUOTA_NO_PROC -2
+
+/* constantes usadas en implementacion del anillo de llamadas */
+#define TAM_ANILLO_LLAMSIS 64	/* peticiones (y resultados) que caben en el anillo */
+#define ARGS_ANILLO_LLAMSIS 4	/* argumentos de una peticion (los que mas recibe un servicio) */
+
+/* Errores del anillo de llamadas */
+#define ANILLO_BAD_PARAM -1
+#define ANILLO_NO_CREADO -2
+
+/* constantes usadas en implementacion de las estadisticas de llamadas */
+#define LLAMSIS_GLOBAL -1		/* id que pide las estadisticas de todo el sistema */
+#define TAM_NOMBRE_LLAMSIS 32
+
+/* Errores de las estadisticas de llamadas */
+#define LLAMSIS_NO_PROC -1
+
+/* constantes usadas en implementacion de la pagina de datos del kernel */
+#define TAM_PAGINA_DATOS 4096
+
+/* constantes usadas en implementacion de la foto de la tabla de procesos */
+#define TAM_NOMBRE_FOTO 32		/* longitud (con el nulo) de los nombres que se copian */
+#define SIN_ESPERA -1			/* no esta bloqueado en un mutex, pipe o cola */
+
+/* constantes usadas en implementacion de las medias de carga, que se
+   guardan en coma fija con BITS_CARGA bits de fraccion y decaen en cada
+   tick con el factor e^(-1/(TICK*segundos)) */
+#define BITS_CARGA 16
+#define UNO_CARGA (1ULL << BITS_CARGA)
+#define DECAE_CARGA_1 64884		/* 1 segundo */
+#define DECAE_CARGA_5 65405		/* 5 segundos */
+#define DECAE_CARGA_15 65492	/* 15 segundos */
+
+/* constantes usadas en implementacion del perfilador */
+#define TAM_PERFIL 4096			/* muestras que guarda el perfil de un proceso */
+#define MARCOS_PERFIL 8			/* marcos de pila en que se busca el PC interrumpido */
+#define TAM_SIMBOLO 128			/* longitud (con el nulo) de "programa:funcion" */
+
+/* Errores del perfilador */
+#define PERFIL_NO_PROC -1
+#define PERFIL_SIN_MEMORIA -2
+#define PERFIL_NO_INICIADO -3
+#define PERFIL_SIN_SIMBOLO -4
+
+/* constantes usadas en implementacion de la medida de secciones criticas */
+#define CUBETAS_SECCION 16		/* cubeta 0: menos de 1 us; i: [2^(i-1), 2^i) us */
+#define TAM_NOMBRE_SECCION 32
+
+/* entrada de la tabla de procesos que corresponde a un indice o a un id */
+#define BCP_ENTRADA(i) (&tabla_procs[(i)/PROCS_POR_BLOQUE][(i)%PROCS_POR_BLOQUE])
+#define ENTRADA_ID(id) ((id)%MAX_TABLA_PROCS)
+
 /*
  *
  * Definici�n del tipo que corresponde con la entrada para la función tiempos_proceso().
@@ -59,12 +260,212 @@ struct tiempos_ejec {
 
 /*
  *
- * Estados adicionales de un proceso
+ * Definición del tipo que corresponde con la entrada para las funciones enviar() y recibir().
+ *
+ */
+struct mensaje {
+    void *datos;
+    unsigned int tam;
+    int prioridad;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_imagenes().
+ *
+ */
+struct estad_imagenes {
+    int aciertos;
+    int fallos;
+    int expulsiones;
+    int residentes;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_pilas().
  *
  */
-#define DORMIDO 4
-#define BLOQUEADO_MTX 5
-#define BLOQUEADO_TERM 6
+struct estad_pilas {
+    int aciertos;
+    int fallos;
+    int libres;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_tr().
+ *
+ */
+struct estad_tr {
+    int activaciones;
+    int fallos;
+    int utilizacion;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_cuota().
+ *
+ */
+struct estad_cuota {
+    unsigned int cuota;
+    unsigned int periodo;
+    unsigned int consumo_total;
+    int estrangulamientos;
+    unsigned int ticks_estrangulado;
+};
+
+/*
+ *
+ * Definición de los tipos que corresponden con el anillo de llamadas que
+ * registra crear_anillo(). El usuario encola peticiones en sub avanzando
+ * cola_sub y recoge resultados de com avanzando cab_com; el kernel hace
+ * lo contrario en entrar_anillo(). Los indices crecen sin limite y se
+ * usan modulo TAM_ANILLO_LLAMSIS.
+ *
+ */
+struct peticion_llamsis {
+    int servicio;
+    long args[ARGS_ANILLO_LLAMSIS];
+    long dato;
+};
+
+struct resultado_llamsis {
+    int res;
+    long dato;
+};
+
+struct anillo_llamsis {
+    unsigned int cab_sub;
+    unsigned int cola_sub;
+    unsigned int cab_com;
+    unsigned int cola_com;
+    struct peticion_llamsis sub[TAM_ANILLO_LLAMSIS];
+    struct resultado_llamsis com[TAM_ANILLO_LLAMSIS];
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con los contadores de un servicio
+ * que se llevan por proceso y globalmente, y con la entrada para la
+ * función estadisticas_llamsis(), que les añade el nombre.
+ *
+ */
+typedef struct {
+    unsigned int llamadas;
+    unsigned int bloqueos;		/* llamadas en las que el proceso se bloqueo */
+    unsigned int errores;		/* llamadas que devolvieron un valor negativo */
+    unsigned long long ns_total;	/* desde que entra hasta que vuelve */
+    unsigned long long ns_sistema;	/* lo mismo sin el tiempo fuera del procesador */
+    unsigned long long ns_max;
+} contadores_llamsis;
+
+struct estad_llamsis {
+    char nombre[TAM_NOMBRE_LLAMSIS];
+    contadores_llamsis c;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la pagina de datos del kernel
+ * que los procesos leen sin hacer llamadas (su direccion la da
+ * datos_kernel()). El kernel la actualiza en cada tick y en cada cambio
+ * de contexto; secuencia es impar mientras la esta escribiendo.
+ *
+ */
+struct datos_kernel {
+    unsigned int secuencia;
+    int id_actual;					/* proceso en ejecucion */
+    unsigned long long ticks;		/* t_ticks */
+    unsigned long long tick_ns;		/* t_tick_ns */
+    unsigned long long usuario;		/* t_usr */
+    unsigned long long sistema;		/* t_sys */
+    unsigned long long proc_usuario;	/* ticks en modo usuario del proceso en ejecucion */
+    unsigned long long proc_sistema;	/* ticks en modo sistema del proceso en ejecucion */
+    void *funcion_hilo;				/* funcion y argumento del proceso en ejecucion */
+    void *arg_hilo;					/* si es un hilo (para la lanzadera) */
+    unsigned long long arranque_ns;	/* t_arranque_ns (fijo desde el arranque) */
+};
+
+/*
+ *
+ * Definición de los tipos que corresponden con la foto de la tabla de
+ * procesos que devuelve foto_procesos(): datos de cada proceso y
+ * recuento de procesos por estado.
+ *
+ */
+struct info_proc {
+    int id;
+    int padre;
+    int estado;
+    char prog[TAM_NOMBRE_FOTO];		/* vacio si su imagen no esta en la cache */
+    int espera;						/* mutex, pipe o cola en que esta bloqueado (o SIN_ESPERA) */
+    char nombre_espera[TAM_NOMBRE_FOTO];
+    int dueno_espera;				/* proceso que tiene el mutex que espera (-1 si no aplica) */
+    unsigned int t_wake;			/* tick en que despierta si esta DORMIDO */
+    unsigned long long ticks_usuario;
+    unsigned long long ticks_sistema;
+    int nice;
+    int mutex_ids[NUM_MUT_PROC];	/* mutex abiertos (MTX_DESC_NO_USADO si no) */
+};
+
+struct foto_sistema {
+    unsigned long long ticks;		/* t_ticks al tomarla */
+    int n_procs;					/* entradas ocupadas, incluidos zombis */
+    int n_listos;					/* listos sin contar el que esta en ejecucion */
+    int n_dormidos;					/* en lista_dormidos */
+    int n_bloqueados;				/* en un mutex, terminal, pipe, cola o esperando a un hijo */
+    int n_estrangulados;
+    int n_zombis;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con los contadores globales que
+ * devuelve estadisticas_sistema().
+ *
+ */
+struct estad_sistema {
+    unsigned long long interrupciones[NVECTORES];	/* tratadas por cada vector */
+    unsigned long long cambios_voluntarios;		/* el proceso se bloquea */
+    unsigned long long cambios_involuntarios;	/* el proceso es expulsado */
+    unsigned long long cambios_fin;				/* el proceso termina */
+    unsigned long long ticks;
+    unsigned long long ticks_ociosos;			/* sin procesos listos (en espera_int) */
+    int ejecutables;					/* listos, incluido el que esta en ejecucion */
+    unsigned int carga[3];				/* media de ejecutables en 1, 5 y 15 s (milesimas) */
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función
+ * leer_perfil().
+ *
+ */
+struct info_perfil {
+    int activo;						/* se estan tomando muestras */
+    int terminado;					/* el proceso ya ha terminado (zombi) */
+    unsigned int muestras;			/* PCs de usuario guardados */
+    unsigned int perdidas;			/* ticks de usuario sin sitio o sin PC en su imagen */
+    unsigned int sistema;			/* ticks en modo sistema mientras se perfilaba */
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función
+ * estadisticas_secciones().
+ *
+ */
+struct estad_seccion {
+    char funcion[TAM_NOMBRE_SECCION];
+    int linea;
+    int nivel;						/* nivel al que sube */
+    unsigned int veces;				/* secciones cerradas */
+    unsigned long long ns_total;
+    unsigned long long ns_max;
+    unsigned int histograma[CUBETAS_SECCION];	/* cubeta 0: < 1 us; i: [2^(i-1), 2^i) us */
+};
 
 /*
  *
@@ -74,28 +475,125 @@ struct tiempos_ejec {
  */
 typedef struct BCP_t *BCPptr;
 
+/*
+ *
+ * Definicion del tipo que corresponde con el perfil de un proceso: los
+ * PCs de usuario que se encuentra la interrupcion de reloj mientras
+ * esta activo.
+ *
+ */
+typedef struct {
+	struct info_perfil info;
+	void *pc[TAM_PERFIL];
+} perfil_proceso;
+
+/*
+ *
+ * Definicion del tipo que corresponde con un punto del kernel que cambia
+ * el nivel de interrupcion. Acumula las secciones criticas que abre: el
+ * tiempo desde que sube el nivel hasta que alguien lo vuelve a bajar.
+ *
+ */
+typedef struct seccion_crit {
+	const char *funcion;
+	int linea;
+	int nivel;						/* nivel al que subio la ultima vez */
+	unsigned int veces;				/* secciones cerradas */
+	unsigned long long ns_total;
+	unsigned long long ns_max;
+	unsigned int histograma[CUBETAS_SECCION];
+	int registrada;					/* ya esta en lista_secciones */
+	struct seccion_crit *siguiente;
+} seccion_crit;
+
+/*
+ * Cada cambio de nivel del kernel pasa por fijar_nivel_medido con un
+ * punto de medida propio (estatico, uno por llamada en el fuente).
+ */
+int fijar_nivel_medido(int nivel, seccion_crit *seccion);
+
+#define fijar_nivel_int(nivel) ({ \
+	static seccion_crit seccion_ = {.funcion=__func__, .linea=__LINE__}; \
+	fijar_nivel_medido((nivel), &seccion_); })
+
+/*
+ *
+ * Definicion del tipo que corresponde con la cabecera de una lista
+ * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
+ * procesos bloqueados en sem�foro, etc.).
+ *
+ */
+typedef struct{
+	BCPptr primero;
+	BCPptr ultimo;
+} lista_BCPs;
+
 typedef struct BCP_t {
-    int id;							/* ident. del proceso */
-	int estado;						/* TERMINADO|LISTO|EJECUCION|BLOQUEADO|DORMIDO|BLOQUEADO_MTX|BLOQUEADO_TERM */
+    int id;							/* ident. del proceso (generacion*MAX_TABLA_PROCS + entrada) */
+	int generacion;					/* nº de veces que se ha usado la entrada */
+	int estado;						/* TERMINADO|LISTO|EJECUCION|BLOQUEADO|DORMIDO|BLOQUEADO_MTX|BLOQUEADO_TERM|BLOQUEADO_PIPE_LEC|BLOQUEADO_PIPE_ESC|BLOQUEADO_COLA_REC|BLOQUEADO_COLA_ENV|ZOMBI|BLOQUEADO_HIJO|ESTRANGULADO */
     contexto_t contexto_regs;		/* copia de regs. de UCP */
 	void * pila;					/* dir. inicial de la pila */
 	BCPptr siguiente;				/* puntero a otro BCP */
 	void *info_mem;					/* descriptor del mapa de memoria */
+	int imagen_id;					/* entrada de la cache de imagenes (IMAGEN_NO_CACHEADA si no esta en ella) */
 	unsigned int t_wake;			/* tiempo (ticks) en que el proceso se despertara */
 	int mutex_ids[NUM_MUT_PROC];	/* descriptores e los mutex que posee el proceso */
+	int pipe_ids[NUM_PIPE_PROC];	/* pipe referenciado por cada descriptor de pipe del proceso */
+	int pipe_modos[NUM_PIPE_PROC];	/* PIPE_BLOQUEANTE|PIPE_NO_BLOQUEANTE de cada descriptor */
+	int cola_ids[NUM_COLA_PROC];	/* descriptores de las colas de mensajes que posee el proceso */
+	unsigned int t_limite;			/* tiempo (ticks) limite de la espera en una cola (0 si no tiene) */
+	int shm_ids[NUM_SHM_PROC];		/* descriptores de las regiones de memoria compartida que posee el proceso */
+	int padre;						/* id del proceso creador (SIN_PADRE si no tiene) */
+	int estado_fin;					/* estado con el que termino (valido en ZOMBI) */
+	int n_hijos;					/* hijos creados que aun no se han esperado */
+	lista_BCPs lista_zombis;		/* hijos terminados que aun no se han esperado */
+	lista_BCPs lista_esperando;		/* procesos bloqueados esperando a un hijo de este */
+	int *refs_imagen;				/* hilos que comparten info_mem (NULL si no ha creado hilos) */
+	void *funcion_hilo;				/* funcion que ejecuta el hilo (NULL si no es un hilo) */
+	void *arg_hilo;					/* argumento de la funcion del hilo */
+	unsigned int periodo;			/* ticks entre activaciones (0 si no es periodico) */
+	unsigned int plazo;				/* ticks desde la activacion para terminar cada trabajo */
+	int densidad;					/* coste/plazo en milesimas, reservado en la admision */
+	unsigned int t_activacion;		/* tick de la activacion del trabajo actual */
+	unsigned int t_plazo;			/* tick limite del trabajo actual (clave de EDF) */
+	int n_activaciones;				/* trabajos completados o perdidos */
+	int n_fallos;					/* trabajos que no terminaron en plazo */
+	unsigned long long vruntime;	/* tiempo virtual consumido (CFS) */
+	int nice;						/* NICE_MIN..NICE_MAX, fija el peso en CFS */
+	int pos_heap;					/* posicion en el monticulo de listos (CFS) */
+	unsigned int cuota;				/* ticks de procesador por periodo de cuota (0 sin limite) */
+	unsigned int periodo_cuota;		/* ticks de cada periodo de cuota */
+	unsigned int consumo_cuota;		/* ticks consumidos en el periodo actual */
+	unsigned int t_fin_cuota;		/* tick en que acaba el periodo actual */
+	unsigned int consumo_total;		/* ticks consumidos desde que se fijo la cuota */
+	int n_estrangulamientos;		/* veces que ha agotado la cuota */
+	unsigned int ticks_estrangulado;	/* ticks que ha pasado estrangulado */
+	unsigned int t_estrangulado;	/* tick en que agoto la cuota por ultima vez */
+	struct anillo_llamsis *anillo;	/* anillo de llamadas registrado (NULL si no tiene) */
+	unsigned int n_bloqueos;		/* veces que ha dejado el procesador por bloquearse */
+	unsigned long long ns_fuera;	/* tiempo total que ha pasado sin el procesador */
+	unsigned long long ticks_usuario;	/* ticks de reloj que le han tocado en modo usuario */
+	unsigned long long ticks_sistema;	/* ticks de reloj que le han tocado en modo sistema */
+	contadores_llamsis llamsis[NSERVICIOS];	/* uso de cada servicio por el proceso */
+	char argumentos[TAM_ARGUMENTOS];	/* cadena recibida al crearlo (vacia si no tiene) */
+	perfil_proceso *perfil;			/* muestras del perfilador (NULL si no se ha iniciado) */
 } BCP;
 
 /*
- *
- * Definicion del tipo que corresponde con la cabecera de una lista
- * de BCPs. Este tipo se puede usar para diversas listas (procesos listos,
- * procesos bloqueados en sem�foro, etc.).
- *
+ * Definicion del tipo que corresponde con una clase de planificacion:
+ * las operaciones con las que el nucleo gestiona los listos de la clase.
+ * Se llaman con las interrupciones inhibidas.
  */
-typedef struct{
-	BCP *primero;
-	BCP *ultimo;
-} lista_BCPs;
+typedef struct {
+	char *nombre;
+	void (*encolar)(BCP *proc);		/* proceso nuevo o expulsado pasa a listo */
+	void (*desencolar)(BCP *proc);	/* sale de la cola al dejar de estar listo */
+	BCP *(*elegir)();				/* siguiente a ejecutar (NULL si no hay) */
+	int (*tick)(BCP *proc);			/* tick del que ejecuta; distinto de 0 para expulsarlo */
+	void (*despertar)(BCP *proc);	/* proceso bloqueado pasa a listo */
+	void (*ceder)(BCP *proc);		/* el que ejecuta cede el procesador */
+} clase_planif;
 
 
 /*
@@ -112,31 +610,211 @@ typedef struct mutex_t {
 	lista_BCPs lista_bloqueados;/* representa la cola de procesos bloqueados por un mutex */
 } mutex;
 
+/*
+ * Definición del tipo correspondiente con el pipe;
+ */
+typedef struct pipe_t *pipeptr;
+
+typedef struct pipe_t {
+	int estado;					/* PIPE_NO_USADO|PIPE_USADO */
+	char *nombre;				/* nombre asociado al pipe (NULL si es anonimo) */
+	char *buffer;				/* buffer circular con los datos del pipe */
+	unsigned int tam;			/* capacidad del buffer */
+	unsigned int inicio;		/* posicion del primer byte pendiente de leer */
+	unsigned int n_bytes;		/* nº de bytes almacenados en el buffer */
+	int n_abiertos;				/* nº de descriptores que referencian al pipe */
+	int n_lectores;				/* nº de esos descriptores que pueden leer */
+	int n_escritores;			/* nº de esos descriptores que pueden escribir */
+	lista_BCPs lista_lectores;	/* cola de procesos bloqueados a la espera de datos */
+	lista_BCPs lista_escritores;/* cola de procesos bloqueados a la espera de hueco */
+} pipe;
+
+/*
+ * Definición del tipo correspondiente con una celda del slab de mensajes;
+ */
+typedef struct celda_msj_t *celdaptr;
+
+typedef struct celda_msj_t {
+	int prioridad;				/* prioridad del mensaje (mayor se entrega antes) */
+	unsigned int tam;			/* tamaño del mensaje */
+	int buf_id;					/* buffer cedido con los datos, BUF_MSJ_NINGUNO si van en la celda */
+	char datos[TAM_MSJ_PEQ];	/* copia de los datos de un mensaje pequeño */
+	celdaptr siguiente;			/* siguiente celda de la cola o de la lista de libres */
+} celda_msj;
+
+/*
+ * Definición del tipo correspondiente con un buffer de mensaje grande,
+ * que se entrega cediendo su propiedad en lugar de copiarlo;
+ */
+typedef struct {
+	void *datos;				/* zona de memoria del buffer (NULL si la entrada no se usa) */
+	unsigned int tam;			/* tamaño de la zona */
+	int dueno;					/* ident. del proceso propietario, -1 si esta en una cola */
+} buffer_msj;
+
+/*
+ * Definición del tipo correspondiente con la cola de mensajes;
+ */
+typedef struct cola_t *colaptr;
+
+typedef struct cola_t {
+	int estado;					/* COLA_NO_USADA|COLA_USADA */
+	char *nombre;				/* nombre asociado a la cola */
+	unsigned int max_mensajes;	/* capacidad de la cola */
+	unsigned int n_mensajes;	/* nº de mensajes encolados */
+	celdaptr primero;			/* mensajes ordenados por prioridad */
+	lista_BCPs lista_receptores;/* cola de procesos bloqueados a la espera de un mensaje */
+	lista_BCPs lista_emisores;	/* cola de procesos bloqueados a la espera de hueco */
+} cola;
+
+/*
+ * Definición del tipo correspondiente con una region de memoria compartida;
+ */
+typedef struct region_t *regionptr;
+
+typedef struct region_t {
+	int estado;					/* SHM_NO_USADA|SHM_USADA */
+	char *nombre;				/* nombre asociado a la region */
+	void *dir;					/* direccion de la region, comun a todos los procesos */
+	unsigned int tam;			/* tamaño de la region */
+	int n_refs;					/* nº de descriptores abiertos sobre la region */
+} region;
+
+/*
+ * Definición del tipo correspondiente con una entrada de la cache de imagenes;
+ */
+typedef struct {
+	char nombre[MAX_NOM_PROG];	/* programa cargado ("" si la entrada no se usa) */
+	void *imagen;				/* descriptor del mapa de memoria */
+	void *pc_inicial;			/* punto de arranque del programa */
+	int n_refs;					/* nº de procesos que usan la imagen */
+	unsigned long ultimo_uso;	/* marca del ultimo uso, para expulsar la menos reciente */
+} imagen_cache;
+
 /*
  * Variable global que identifica el proceso actual
  */
 BCP * p_proc_actual=NULL;
 
 /*
- * Variable global que representa la tabla de procesos
+ * Variable global que representa la tabla de procesos, formada por 
+ * bloques de PROCS_POR_BLOQUE BCPs que se reservan segun se necesitan
  */
-BCP tabla_procs[MAX_PROC];
+BCP *tabla_procs[MAX_BLOQUES_PROC];
+int num_entradas_procs = 0;
+
+/*
+ * Id del proceso inicial, que adopta a los hijos vivos de los procesos
+ * que terminan
+ */
+int id_init = SIN_PADRE;
+
+/*
+ * Variable global que representa la pila de entradas libres de la tabla de procesos
+ */
+int procs_libres[MAX_TABLA_PROCS];
+int num_procs_libres = 0;
 
 /*
  * Variable global que representa la tabla de mutex
  */
 mutex tabla_mutex[NUM_MUT];
 
+/*
+ * Variable global que representa la tabla de pipes
+ */
+pipe tabla_pipes[NUM_PIPES];
+
+/*
+ * Variable global que representa la tabla de colas de mensajes
+ */
+cola tabla_colas[NUM_COLAS];
+
+/*
+ * Variables globales que representan el slab de celdas de mensaje
+ * y la lista de sus celdas libres
+ */
+celda_msj slab_mensajes[NUM_MSJ_SLAB];
+celdaptr celdas_libres = NULL;
+
+/*
+ * Variable global que representa la tabla de buffers de mensajes grandes
+ */
+buffer_msj tabla_buffers[NUM_BUF_MSJ];
+
+/*
+ * Variable global que representa la tabla de regiones de memoria compartida
+ */
+region tabla_shm[NUM_SHM];
+
+/*
+ * Variables globales que representan la cache de imagenes, el reloj
+ * logico usado para el LRU y sus contadores de uso
+ */
+imagen_cache tabla_imagenes[NUM_IMAGENES];
+unsigned long reloj_imagenes = 0;
+struct estad_imagenes estad_cache = {0, 0, 0, 0};
+
+/*
+ * Variables globales que representan el pool de pilas libres (encadenadas
+ * a traves de su primera palabra) y sus contadores de uso
+ */
+void *pool_pilas = NULL;
+struct estad_pilas estad_pool = {0, 0, 0};
+
 /*
  * Variable global que representa la cola de procesos listos
  */
 lista_BCPs lista_listos = {NULL, NULL};
 
+/*
+ * Variable global que representa la cola de procesos periodicos listos,
+ * ordenada por plazo (EDF), y la utilizacion que tienen reservada
+ */
+lista_BCPs lista_tr = {NULL, NULL};
+int utilizacion_tr = 0;
+
+/*
+ * Variable global que representa la clase de planificacion de los
+ * procesos no periodicos, elegida en el arranque
+ */
+clase_planif *clase_normal = NULL;
+
+/*
+ * Variables globales de la clase CFS: monticulo de procesos listos
+ * ordenado por vruntime (sustituye a lista_listos) y el menor vruntime
+ * visto, que marca el punto de partida de los nuevos
+ */
+BCP *heap_cfs[MAX_TABLA_PROCS];
+int num_heap_cfs = 0;
+unsigned long long min_vruntime = 0;
+
+/*
+ * Peso de cada valor de nice (de NICE_MIN a NICE_MAX); cada nivel
+ * reparte aproximadamente un 25% mas o menos de procesador
+ */
+const int pesos_nice[NICE_MAX - NICE_MIN + 1] = {
+	/* -20 */ 88761, 71755, 56483, 46273, 36291,
+	/* -15 */ 29154, 23254, 18705, 14949, 11916,
+	/* -10 */  9548,  7620,  6100,  4904,  3906,
+	/*  -5 */  3121,  2501,  1991,  1586,  1277,
+	/*   0 */  1024,   820,   655,   526,   423,
+	/*   5 */   335,   272,   215,   172,   137,
+	/*  10 */   110,    87,    70,    56,    45,
+	/*  15 */    36,    29,    23,    18,    15
+};
+
 /*
  * Variable global que representa la cola de procesos dormidos
  */
 lista_BCPs lista_dormidos = {NULL, NULL};
 
+/*
+ * Variable global que representa la cola de procesos que han agotado
+ * su cuota y esperan al siguiente periodo
+ */
+lista_BCPs lista_estrangulados = {NULL, NULL};
+
 /*
  * Variable global que representa la cola de procesos bloqueados
  * a la espera de liberar el hueco de un mutex
@@ -149,6 +827,44 @@ lista_BCPs lista_bloqueados_mtx = {NULL, NULL};
  */
 lista_BCPs lista_bloqueados_term = {NULL, NULL};
 
+/*
+ * Variable global con el uso de cada servicio por todos los procesos
+ */
+contadores_llamsis llamsis_global[NSERVICIOS];
+
+/*
+ * Variables globales que representan la pagina de datos del kernel: la
+ * misma memoria vista con permiso de escritura (para el kernel) y de
+ * solo lectura (la que se da a los procesos)
+ */
+struct datos_kernel *datos_kernel = NULL;
+struct datos_kernel *datos_usuario = NULL;
+
+/*
+ * Variables globales que representan los contadores del sistema y las
+ * medias de carga (en coma fija, ver BITS_CARGA), que se actualizan en
+ * cada tick a partir del numero de procesos ejecutables
+ */
+struct estad_sistema estad_sistema;
+unsigned long long carga_fija[3] = {0, 0, 0};
+int n_ejecutables = 0;
+
+/*
+ * Variable global que indica que el proceso en ejecucion deja el
+ * procesador sin bloquearse porque lo pide (cuenta como voluntario)
+ */
+int cesion = 0;
+
+/*
+ * Variables globales de la medida de secciones criticas: los puntos que
+ * han cerrado alguna y, para cada nivel, el punto que lo subio y cuando
+ * (NULL si no lo subio ninguno o ya bajo)
+ */
+seccion_crit *lista_secciones = NULL;
+int n_secciones = 0;
+seccion_crit *seccion_abierta[NUM_NIVELES+1];
+unsigned long long t_seccion[NUM_NIVELES+1];
+
 /*
  *
  * Definici�n del tipo que corresponde con una entrada en la tabla de
@@ -157,6 +873,7 @@ lista_BCPs lista_bloqueados_term = {NULL, NULL};
  */
 typedef struct{
 	int (*fservicio)();
+	char *nombre;			/* para las estadisticas de llamadas */
 } servicio;
 
 /*
@@ -168,6 +885,18 @@ typedef struct{
  */
 unsigned long long int t_ticks = 0, t_usr = 0, t_sys = 0, t_proc = 0;
 
+/*
+ * Variable global con el instante del arranque (en ns del reloj monotono
+ * de la maquina anfitriona), origen de obtener_tiempo_ns
+ */
+unsigned long long t_arranque_ns = 0;
+
+/*
+ * Variable global con el instante del ultimo tick, en la escala de
+ * obtener_tiempo_ns
+ */
+unsigned long long t_tick_ns = 0;
+
 /*
  *
  * Variable global empleada para indicarcuando se esta accediendo a un parámetro
@@ -202,22 +931,114 @@ int sis_lock();
 int sis_unlock();
 int sis_cerrar_mutex();
 int sis_leer_caracter();
+int sis_crear_pipe();
+int sis_abrir_pipe();
+int sis_leer_pipe();
+int sis_escribir_pipe();
+int sis_cerrar_pipe();
+int sis_crear_cola();
+int sis_abrir_cola();
+int sis_enviar();
+int sis_recibir();
+int sis_cerrar_cola();
+int sis_reservar_mensaje();
+int sis_liberar_mensaje();
+int sis_crear_memoria_compartida();
+int sis_abrir_memoria_compartida();
+int sis_cerrar_memoria_compartida();
+int sis_estadisticas_imagenes();
+int sis_vaciar_cache_imagenes();
+int sis_estadisticas_pilas();
+int sis_crear_procesos();
+int sis_esperar_proceso();
+int sis_salir();
+int sis_crear_hilo();
+int sis_ceder_procesador();
+int sis_dormir_ticks();
+int sis_dormir_hasta();
+int sis_crear_temporizador_periodico();
+int sis_esperar_periodo();
+int sis_estadisticas_tr();
+int sis_fijar_nice();
+int sis_fijar_cuota();
+int sis_estadisticas_cuota();
+int sis_crear_anillo();
+int sis_entrar_anillo();
+int sis_estadisticas_llamsis();
+int sis_datos_kernel();
+int sis_obtener_tiempo_ns();
+int sis_obtener_hora();
+int sis_crear_proceso_args();
+int sis_argumentos();
+int sis_foto_procesos();
+int sis_estadisticas_sistema();
+int sis_iniciar_perfil();
+int sis_parar_perfil();
+int sis_leer_perfil();
+int sis_simbolizar();
+int sis_estadisticas_secciones();
 
 /*
  * Variable global que contiene las rutinas que realizan cada llamada
  */
-servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso},
-					{sis_terminar_proceso},
-					{sis_escribir},
-					{sis_obtener_id_pr},
-					{sis_dormir},
-					{sis_tiempos_proceso},
-					{sis_crear_mutex},
-					{sis_abrir_mutex},
-					{sis_lock},
-					{sis_unlock},
-					{sis_cerrar_mutex},
-					{sis_leer_caracter}};
+servicio tabla_servicios[NSERVICIOS]={	{sis_crear_proceso, "crear_proceso"},
+					{sis_terminar_proceso, "terminar_proceso"},
+					{sis_escribir, "escribir"},
+					{sis_obtener_id_pr, "obtener_id_pr"},
+					{sis_dormir, "dormir"},
+					{sis_tiempos_proceso, "tiempos_proceso"},
+					{sis_crear_mutex, "crear_mutex"},
+					{sis_abrir_mutex, "abrir_mutex"},
+					{sis_lock, "lock"},
+					{sis_unlock, "unlock"},
+					{sis_cerrar_mutex, "cerrar_mutex"},
+					{sis_leer_caracter, "leer_caracter"},
+					{sis_crear_pipe, "crear_pipe"},
+					{sis_abrir_pipe, "abrir_pipe"},
+					{sis_leer_pipe, "leer_pipe"},
+					{sis_escribir_pipe, "escribir_pipe"},
+					{sis_cerrar_pipe, "cerrar_pipe"},
+					{sis_crear_cola, "crear_cola"},
+					{sis_abrir_cola, "abrir_cola"},
+					{sis_enviar, "enviar"},
+					{sis_recibir, "recibir"},
+					{sis_cerrar_cola, "cerrar_cola"},
+					{sis_reservar_mensaje, "reservar_mensaje"},
+					{sis_liberar_mensaje, "liberar_mensaje"},
+					{sis_crear_memoria_compartida, "crear_memoria_compartida"},
+					{sis_abrir_memoria_compartida, "abrir_memoria_compartida"},
+					{sis_cerrar_memoria_compartida, "cerrar_memoria_compartida"},
+					{sis_estadisticas_imagenes, "estadisticas_imagenes"},
+					{sis_vaciar_cache_imagenes, "vaciar_cache_imagenes"},
+					{sis_estadisticas_pilas, "estadisticas_pilas"},
+					{sis_crear_procesos, "crear_procesos"},
+					{sis_esperar_proceso, "esperar_proceso"},
+					{sis_salir, "salir"},
+					{sis_crear_hilo, "crear_hilo"},
+					{sis_ceder_procesador, "ceder_procesador"},
+					{sis_dormir_ticks, "dormir_ticks"},
+					{sis_dormir_hasta, "dormir_hasta"},
+					{sis_crear_temporizador_periodico, "crear_temporizador_periodico"},
+					{sis_esperar_periodo, "esperar_periodo"},
+					{sis_estadisticas_tr, "estadisticas_tr"},
+					{sis_fijar_nice, "fijar_nice"},
+					{sis_fijar_cuota, "fijar_cuota"},
+					{sis_estadisticas_cuota, "estadisticas_cuota"},
+					{sis_crear_anillo, "crear_anillo"},
+					{sis_entrar_anillo, "entrar_anillo"},
+					{sis_estadisticas_llamsis, "estadisticas_llamsis"},
+					{sis_datos_kernel, "datos_kernel"},
+					{sis_obtener_tiempo_ns, "obtener_tiempo_ns"},
+					{sis_obtener_hora, "obtener_hora"},
+					{sis_crear_proceso_args, "crear_proceso_args"},
+					{sis_argumentos, "argumentos"},
+					{sis_foto_procesos, "foto_procesos"},
+					{sis_estadisticas_sistema, "estadisticas_sistema"},
+					{sis_iniciar_perfil, "iniciar_perfil"},
+					{sis_parar_perfil, "parar_perfil"},
+					{sis_leer_perfil, "leer_perfil"},
+					{sis_simbolizar, "simbolizar"},
+					{sis_estadisticas_secciones, "estadisticas_secciones"}};
 
 #endif /* _KERNEL_H */
 
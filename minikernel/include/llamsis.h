@@ -19,7 +19,7 @@
 #define _LLAMSIS_H
 
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 12
+#define NSERVICIOS 58
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
@@ -33,6 +33,52 @@
 #define UNLOCK 9
 #define CERRAR_MUTEX 10
 #define LEER_CARACTER 11
+#define CREAR_PIPE 12
+#define ABRIR_PIPE 13
+#define LEER_PIPE 14
+#define ESCRIBIR_PIPE 15
+#define CERRAR_PIPE 16
+#define CREAR_COLA 17
+#define ABRIR_COLA 18
+#define ENVIAR 19
+#define RECIBIR 20
+#define CERRAR_COLA 21
+#define RESERVAR_MENSAJE 22
+#define LIBERAR_MENSAJE 23
+#define CREAR_MEM_COMPARTIDA 24
+#define ABRIR_MEM_COMPARTIDA 25
+#define CERRAR_MEM_COMPARTIDA 26
+#define ESTADISTICAS_IMAGENES 27
+#define VACIAR_CACHE_IMAGENES 28
+#define ESTADISTICAS_PILAS 29
+#define CREAR_PROCESOS 30
+#define ESPERAR_PROCESO 31
+#define SALIR 32
+#define CREAR_HILO 33
+#define CEDER_PROCESADOR 34
+#define DORMIR_TICKS 35
+#define DORMIR_HASTA 36
+#define CREAR_TEMPORIZADOR_PERIODICO 37
+#define ESPERAR_PERIODO 38
+#define ESTADISTICAS_TR 39
+#define FIJAR_NICE 40
+#define FIJAR_CUOTA 41
+#define ESTADISTICAS_CUOTA 42
+#define CREAR_ANILLO 43
+#define ENTRAR_ANILLO 44
+#define ESTADISTICAS_LLAMSIS 45
+#define DATOS_KERNEL 46
+#define OBTENER_TIEMPO_NS 47
+#define OBTENER_HORA 48
+#define CREAR_PROCESO_ARGS 49
+#define ARGUMENTOS 50
+#define FOTO_PROCESOS 51
+#define ESTADISTICAS_SISTEMA 52
+#define INICIAR_PERFIL 53
+#define PARAR_PERFIL 54
+#define LEER_PERFIL 55
+#define SIMBOLIZAR 56
+#define ESTADISTICAS_SECCIONES 57
 
 #endif /* _LLAMSIS_H */
 
@@ -14,8 +14,17 @@
  *
  */
 
+#define _GNU_SOURCE	/* Para emplear mremap */
 #include "kernel.h"	/* Contiene defs. usadas por este modulo */
 #include <string.h> /* Para emplear la funcion strdup */
+#include <stdlib.h> /* Para emplear las funciones malloc y free */
+#include <time.h> /* Para emplear la funcion clock_gettime */
+#include <sys/mman.h> /* Para emplear las funciones mmap, mremap y mprotect */
+#include <sys/stat.h> /* Para emplear la funcion fstat */
+#include <stdio.h> /* Para emplear las funciones fopen y fclose */
+#include <execinfo.h> /* Para emplear la funcion backtrace */
+#include <dlfcn.h> /* Para emplear las funciones dladdr y dlinfo */
+#include <link.h> /* Para emplear struct link_map y los tipos ELF */
 
 /* Funciones auxiliares relacionadas con los mutex */
 /*
@@ -86,10 +95,10 @@ int open_mutex_count(int id) {
 	int i, j, n=0;
 
 	// Recorremos los descriptores de mutex asociados al proceso
-	for (i = 0; i < MAX_PROC; i++)
+	for (i = 0; i < num_entradas_procs; i++)
 		for (j = 0; j < NUM_MUT_PROC; j++)
-			if (tabla_mutex[tabla_procs[i].mutex_ids[j]].estado != MTX_NO_USADO
-				&& tabla_procs[i].mutex_ids[j] == id) {
+			if (tabla_mutex[BCP_ENTRADA(i)->mutex_ids[j]].estado != MTX_NO_USADO
+				&& BCP_ENTRADA(i)->mutex_ids[j] == id) {
 				n++;
 			}
 
@@ -196,889 +205,4474 @@ int mutex_is_opened(int id) {
 	return MUTEX_CLOSED;
 }
 
+/* Funciones auxiliares de los objetos con nombre (pipes, colas y regiones) */
 /*
- *
- * Funciones relacionadas con la tabla de procesos:
- *	iniciar_tabla_proc buscar_BCP_libre
- *
+ * Copia en el buffer del kernel nombre, de tam bytes, el nombre que
+ * pasa el proceso en dir. Devuelve su longitud, o -1 si no cabe (en
+ * nombre queda truncado). Un puntero no valido termina el proceso.
  */
+static int leer_nombre(char *nombre, const char *dir, int tam) {
 
-/*
- * Funci�n que inicia la tabla de procesos
- */
-static void iniciar_tabla_proc(){
-	int i;
+	// Variables
+	int len;
 
-	for (i=0; i<MAX_PROC; i++) 
-		tabla_procs[i] = (BCP) {
-			.estado=NO_USADA,
-			.mutex_ids ={[0 ... NUM_MUT_PROC-1] = MTX_DESC_NO_USADO}
-		};
+	acc_param = 1;
+	for (len = 0; len < tam && (nombre[len] = dir[len]) != '\0'; len++);
+	acc_param = 0;
+
+	if (len < tam)
+		return len;
+	nombre[tam-1] = '\0';
+	return -1;
 }
 
+/* Funciones auxiliares relacionadas con los pipes */
 /*
- * Funci�n que busca una entrada libre en la tabla de procesos
+ * Devuelve el numero de descriptores de pipe que posee un proceso.
  */
-static int buscar_BCP_libre(){
-	int i;
+int num_pipe_desc() {
 
-	for (i=0; i<MAX_PROC; i++)
-		if (tabla_procs[i].estado==NO_USADA)
-			return i;
-	return -1;
+	// Variables
+	int i, n=0;
+
+	// Recorremos los descriptores de pipe asociados al proceso
+	for (i = 0; i < NUM_PIPE_PROC; i++)
+		if (p_proc_actual->pipe_ids[i] != PIPE_DESC_NO_USADO)
+			n++;
+
+	return n;
 }
 
 /*
- *
- * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
- *
- * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
+ * Suma inc (1 o -1) a las referencias del pipe id de un descriptor
+ * con el modo dado, contando aparte los extremos de lectura y escritura.
  */
+void ref_pipe_desc(int id, int modo, int inc) {
+	tabla_pipes[id].n_abiertos += inc;
+	if (PIPE_LEE(modo))
+		tabla_pipes[id].n_lectores += inc;
+	if (PIPE_ESCRIBE(modo))
+		tabla_pipes[id].n_escritores += inc;
+}
 
 /*
- * Inserta un BCP al final de la lista.
+ * Añade un descriptor a la tabla de descriptores de pipe
+ * asociados al proceso. Devuelve el descriptor si todo va bien,
+ * PIPE_MAX_DESC en caso de que no haya hueco.
  */
-static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
-	if (lista->primero==NULL)
-		lista->primero= proc;
-	else
-		lista->ultimo->siguiente=proc;
-	lista->ultimo= proc;
-	proc->siguiente=NULL;
+int add_pipe_desc(int id, int modo) {
+
+	// Variables
+	int i;
+
+	// Recorremos los descriptores de pipe asociados al proceso
+	for (i = 0; i < NUM_PIPE_PROC; i++)
+		if (p_proc_actual->pipe_ids[i] == PIPE_DESC_NO_USADO) {
+			p_proc_actual->pipe_ids[i] = id;
+			p_proc_actual->pipe_modos[i] = modo;
+			ref_pipe_desc(id, modo, 1);
+			return i;
+		}
+
+	// Error
+	return PIPE_MAX_DESC;
 }
 
 /*
- * Elimina el primer BCP de la lista.
+ * Devuelve el id del pipe asociado a un descriptor del proceso,
+ * PIPE_CLOSED si el descriptor no esta en uso.
  */
-static void eliminar_primero(lista_BCPs *lista){
+int pipe_desc_id(unsigned int desc) {
 
-	if (lista->ultimo==lista->primero)
-		lista->ultimo=NULL;
-	lista->primero=lista->primero->siguiente;
+	if (desc >= NUM_PIPE_PROC ||
+		p_proc_actual->pipe_ids[desc] == PIPE_DESC_NO_USADO)
+		return PIPE_CLOSED;
+
+	return p_proc_actual->pipe_ids[desc];
 }
 
 /*
- * Elimina un determinado BCP de la lista.
+ * Busca un pipe con nombre y devuelve su id si existe,
+ * PIPE_NO_EXIST si no.
  */
-static void eliminar_elem(lista_BCPs *lista, BCP * proc){
-	BCP *paux=lista->primero;
+int pipe_search_name(char* nombre) {
 
-	if (paux==proc)
-		eliminar_primero(lista);
-	else {
-		for ( ; ((paux) && (paux->siguiente!=proc));
-			paux=paux->siguiente);
-		if (paux) {
-			if (lista->ultimo==paux->siguiente)
-				lista->ultimo=paux;
-			paux->siguiente=paux->siguiente->siguiente;
-		}
-	}
+	// Variables
+	int i;
+
+	for (i = 0; i < NUM_PIPES; i++)
+		if (tabla_pipes[i].estado != PIPE_NO_USADO &&
+			tabla_pipes[i].nombre != NULL &&
+			strcmp(tabla_pipes[i].nombre, nombre) == 0)
+			return i;
+
+	// Error
+	return PIPE_NO_EXIST;
 }
 
 /*
- * Despierta al primer BCP almacenado en una lista cambiando su estado,
- * pasandolo a la lista de listos y eliminandolo de la lista actual.
+ * Función que devuelve el índice de un hueco en la tabla de pipes,
+ * PIPE_TABLE_FULL si no quedan.
  */
-static void despierta_primero(lista_BCPs *lista){
+int get_avail_pipe() {
 
 	// Variables
-	BCPptr p;
-	int n_int;
+	int i;
 
-	p = lista->primero;
-	if (p != NULL) {
-		// Cambiamos su estado
-		p->estado = LISTO;
+	for (i = 0; i < NUM_PIPES; i++)
+		if (tabla_pipes[i].estado == PIPE_NO_USADO)
+			return i;
 
-		// Inhibir interrupciones
-		n_int = fijar_nivel_int(NIVEL_3);
+	// Error
+	return PIPE_TABLE_FULL;
+}
 
-		// Modificar listas de BCPs
-		eliminar_elem(lista,p);
-		insertar_ultimo(&lista_listos,p);
+/* Funciones auxiliares relacionadas con las colas de mensajes */
+/*
+ * Devuelve el numero de descriptores de cola que posee un proceso.
+ */
+int num_cola_desc() {
 
-		// Deshinibir interrupciones
-		fijar_nivel_int(n_int);
-	}
+	// Variables
+	int i, n=0;
+
+	// Recorremos los descriptores de cola asociados al proceso
+	for (i = 0; i < NUM_COLA_PROC; i++)
+		if (p_proc_actual->cola_ids[i] != COLA_DESC_NO_USADO)
+			n++;
+
+	return n;
 }
 
 /*
- *
- * Funciones relacionadas con la planificacion
- *	espera_int planificador
+ * Añade un descriptor a la tabla de descriptores de cola
+ * asociados al proceso. Devuelve 0 si todo va bien,
+ * COLA_MAX_DESC en caso de que no haya hueco.
  */
+int add_cola_desc(int id) {
+
+	// Variables
+	int i;
+
+	// Recorremos los descriptores de cola asociados al proceso
+	for (i = 0; i < NUM_COLA_PROC; i++)
+		if (p_proc_actual->cola_ids[i] == COLA_DESC_NO_USADO) {
+			p_proc_actual->cola_ids[i] = id;
+			return 0;
+		}
+
+	// Error
+	return COLA_MAX_DESC;
+}
 
 /*
- * Espera a que se produzca una interrupcion
+ * Elimina un descriptor de la tabla de descriptores de cola
+ * asociados al proceso. Devuelve 0 si todo va bien,
+ * COLA_CLOSED en caso de que no lo tenga asociado.
  */
-static void espera_int(){
-	int nivel;
+int del_cola_desc(int id) {
 
-	printk("[%f] \tNO HAY LISTOS. ESPERA INT\n", (float) t_ticks/TICK);
+	// Variables
+	int i;
 
-	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
-	nivel=fijar_nivel_int(NIVEL_1);
-	halt();
-	fijar_nivel_int(nivel);
+	// Recorremos los descriptores de cola asociados al proceso
+	for (i = 0; i < NUM_COLA_PROC; i++)
+		if (p_proc_actual->cola_ids[i] == id) {
+			p_proc_actual->cola_ids[i] = COLA_DESC_NO_USADO;
+			return 0;
+		}
+
+	// Error
+	return COLA_CLOSED;
 }
 
 /*
- * Funci�n de planificacion que implementa un algoritmo FIFO.
+ * Devuelve 0 si el proceso que la invoca tiene abierta la
+ * cola cuyo id se pasa como argumento, COLA_CLOSED si no.
  */
-static BCP * planificador(){
-	while (lista_listos.primero==NULL)
-		espera_int();		/* No hay nada que hacer */
-	return lista_listos.primero;
+int cola_is_opened(int id) {
+
+	// Variables
+	int i;
+
+	// Recorremos los descriptores de cola asociados al proceso
+	for (i = 0; i < NUM_COLA_PROC; i++)
+		if (p_proc_actual->cola_ids[i] == id)
+			return 0;
+
+	// Error
+	return COLA_CLOSED;
 }
 
 /*
- * Función que realiza el cambio de contexto al proceso 
- * de la siguiente rodaja
+ * Devuelve el número de procesos que tienen abierta una determinada
+ * cola.
  */
-static void siguiente_rodaja() {
+int open_cola_count(int id) {
 
 	// Variables
-	BCPptr old_p;
-	int n_int;
+	int i, j, n=0;
 
-	printk("[%f] \tSIGUIENTE RODAJA\n", (float) t_ticks/TICK);
+	for (i = 0; i < num_entradas_procs; i++)
+		for (j = 0; j < NUM_COLA_PROC; j++)
+			if (BCP_ENTRADA(i)->cola_ids[j] == id)
+				n++;
 
-	// Reestablecemos el contador de la rodaja
-	t_proc = 0;
+	return n;
+}
 
-	// Inhibir interrupciones
-	n_int = fijar_nivel_int(NIVEL_3);
+/*
+ * Busca una cola por su nombre y devuelve su id si existe,
+ * COLA_NO_EXIST si no.
+ */
+int cola_search_name(char* nombre) {
 
-	// Modificar listas de BCPs
-	old_p = p_proc_actual;
-	eliminar_primero(&lista_listos);
+	// Variables
+	int i;
 
-	// Casuisticas de un proceso
-	switch (p_proc_actual->estado) {
-		case LISTO:
-			printk("[%f] \tPROCESO %d PASA A LA COLA DE LISTOS\n", (float) t_ticks/TICK, sis_obtener_id_pr());
-			insertar_ultimo(&lista_listos, p_proc_actual);
-			break;
-		case DORMIDO:
-			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS\n", (float) t_ticks/TICK, sis_obtener_id_pr());
-			insertar_ultimo(&lista_dormidos, p_proc_actual);
-			break;
-		case BLOQUEADO:
-			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE UN DESCRIPTOR LIBRE\n", 
-				(float) t_ticks/TICK, sis_obtener_id_pr());
-			insertar_ultimo(&lista_bloqueados_mtx, p_proc_actual);
-			break;
-		case BLOQUEADO_MTX:
-			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE LIBERAR EL MUTEX %d (%s)\n", 
-				(float) t_ticks/TICK, sis_obtener_id_pr(), (int)leer_registro(1), tabla_mutex[(int)leer_registro(1)].nombre);
-			insertar_ultimo(&tabla_mutex[(int)leer_registro(1)].lista_bloqueados, p_proc_actual);
-			break;
-		case BLOQUEADO_TERM:
-			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE LEER UN CARACTER\n", 
-				(float) t_ticks/TICK, sis_obtener_id_pr());
-			insertar_ultimo(&lista_bloqueados_term, p_proc_actual);
-			break;
-		default:
-			break;
-	}
+	for (i = 0; i < NUM_COLAS; i++)
+		if (tabla_colas[i].estado != COLA_NO_USADA &&
+			strcmp(tabla_colas[i].nombre, nombre) == 0)
+			return i;
 
-	// Deshinibir interrupciones
-	fijar_nivel_int(n_int);
+	// Error
+	return COLA_NO_EXIST;
+}
 
-	// Invocar planificador para obtener nuevo proceso
-	p_proc_actual = planificador();
-	p_proc_actual->estado = EJECUCION;
+/*
+ * Función que devuelve el índice de un hueco en la tabla de colas,
+ * COLA_TABLE_FULL si no quedan.
+ */
+int get_avail_cola() {
 
-	// Si es el unico proceso en el sistema, se duerme y se despierta no se deberia hacer c. contexto
-	if (old_p->id != p_proc_actual->id) {
-		if (old_p->estado == TERMINADO)
-			printk("[%f] \tC.CONTEXTO POR FIN:", (float) t_ticks/TICK);
-		else if (old_p->estado == BLOQUEADO ||
-			old_p->estado == DORMIDO ||
-			old_p->estado == BLOQUEADO_MTX ||
-			old_p->estado == BLOQUEADO_TERM)
-			printk("[%f] \tC.CONTEXTO VOLUNTARIO:", (float) t_ticks/TICK);
-		else
-			printk("[%f] \tC.CONTEXTO INVOLUNTARIO:", (float) t_ticks/TICK);
-		printk("%d a %d\n", old_p->id, p_proc_actual->id);
+	// Variables
+	int i;
 
-		// Cambio de contexto
-		if (old_p->estado == TERMINADO)
-			cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-		else
-			cambio_contexto(&(old_p->contexto_regs), &(p_proc_actual->contexto_regs));
-	}
+	for (i = 0; i < NUM_COLAS; i++)
+		if (tabla_colas[i].estado == COLA_NO_USADA)
+			return i;
+
+	// Error
+	return COLA_TABLE_FULL;
 }
 
 /*
- *
- * Funcion auxiliar que termina proceso actual liberando sus recursos.
- * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
- *
+ * Encadena todas las celdas del slab de mensajes en la lista de libres.
  */
-static void liberar_proceso(){
+static void iniciar_slab_mensajes() {
 
 	// Variables
 	int i;
 
-	// Cerrando mutexes que tenga asociados
-	for (i = 0; i < NUM_MUT_PROC; i++){
-		if (p_proc_actual->mutex_ids[i] != MTX_DESC_NO_USADO){
-			escribir_registro(1, p_proc_actual->mutex_ids[i]);
-			sis_cerrar_mutex();
-		}
-		p_proc_actual->mutex_ids[i] = MTX_DESC_NO_USADO;
+	for (i = 0; i < NUM_MSJ_SLAB; i++) {
+		slab_mensajes[i].siguiente = celdas_libres;
+		celdas_libres = &slab_mensajes[i];
 	}
+}
 
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
-	liberar_pila(p_proc_actual->pila); /* liberar pila */
+/*
+ * Toma una celda libre del slab de mensajes, NULL si no quedan.
+ */
+static celdaptr reservar_celda() {
 
-	p_proc_actual->estado=TERMINADO;
+	// Variables
+	celdaptr c = celdas_libres;
 
-	// Siguiente proceso
-	siguiente_rodaja();
+	if (c != NULL)
+		celdas_libres = c->siguiente;
 
-    return; /* no deber�a llegar aqui */
+	return c;
 }
 
 /*
- *
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
- *
+ * Devuelve una celda al slab de mensajes.
  */
+static void liberar_celda(celdaptr c) {
+	c->siguiente = celdas_libres;
+	celdas_libres = c;
+}
 
 /*
- * Tratamiento de excepciones aritmeticas
+ * Busca el buffer de mensaje grande que empieza en una direccion
+ * y devuelve su indice si existe, -1 si no.
  */
-static void exc_arit(){
+int buffer_search_dir(void *datos) {
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
+	// Variables
+	int i;
 
+	for (i = 0; i < NUM_BUF_MSJ; i++)
+		if (datos != NULL && tabla_buffers[i].datos == datos)
+			return i;
 
-	printk("[%f] \tEXCEPCION ARITMETICA EN PROC %d\n", (float) t_ticks/TICK, p_proc_actual->id);
-	liberar_proceso();
+	// Error
+	return -1;
+}
 
-        return; /* no deber�a llegar aqui */
+/*
+ * Libera la memoria de un buffer de mensaje grande.
+ */
+void eliminar_buffer(int id) {
+	free(tabla_buffers[id].datos);
+	tabla_buffers[id].datos = NULL;
 }
 
+/* Funciones auxiliares relacionadas con la memoria compartida */
 /*
- * Tratamiento de excepciones en el acceso a memoria
+ * Devuelve el numero de descriptores de region que posee un proceso.
  */
-static void exc_mem(){
+int num_shm_desc() {
+
+	// Variables
+	int i, n=0;
+
+	// Recorremos los descriptores de region asociados al proceso
+	for (i = 0; i < NUM_SHM_PROC; i++)
+		if (p_proc_actual->shm_ids[i] != SHM_DESC_NO_USADO)
+			n++;
+
+	return n;
+}
+
+/*
+ * Añade un descriptor a la tabla de descriptores de region
+ * asociados al proceso. Devuelve 0 si todo va bien,
+ * SHM_MAX_DESC en caso de que no haya hueco.
+ */
+int add_shm_desc(int id) {
+
+	// Variables
+	int i;
+
+	// Recorremos los descriptores de region asociados al proceso
+	for (i = 0; i < NUM_SHM_PROC; i++)
+		if (p_proc_actual->shm_ids[i] == SHM_DESC_NO_USADO) {
+			p_proc_actual->shm_ids[i] = id;
+			tabla_shm[id].n_refs++;
+			return 0;
+		}
+
+	// Error
+	return SHM_MAX_DESC;
+}
+
+/*
+ * Elimina un descriptor de la tabla de descriptores de region
+ * asociados al proceso. Devuelve 0 si todo va bien,
+ * SHM_CLOSED en caso de que no lo tenga asociado.
+ */
+int del_shm_desc(int id) {
+
+	// Variables
+	int i;
+
+	// Recorremos los descriptores de region asociados al proceso
+	for (i = 0; i < NUM_SHM_PROC; i++)
+		if (p_proc_actual->shm_ids[i] == id) {
+			p_proc_actual->shm_ids[i] = SHM_DESC_NO_USADO;
+			tabla_shm[id].n_refs--;
+			return 0;
+		}
+
+	// Error
+	return SHM_CLOSED;
+}
+
+/*
+ * Busca una region por su nombre y devuelve su id si existe,
+ * SHM_NO_EXIST si no.
+ */
+int shm_search_name(char* nombre) {
+
+	// Variables
+	int i;
+
+	for (i = 0; i < NUM_SHM; i++)
+		if (tabla_shm[i].estado != SHM_NO_USADA &&
+			strcmp(tabla_shm[i].nombre, nombre) == 0)
+			return i;
+
+	// Error
+	return SHM_NO_EXIST;
+}
+
+/*
+ * Función que devuelve el índice de un hueco en la tabla de regiones,
+ * SHM_TABLE_FULL si no quedan.
+ */
+int get_avail_shm() {
+
+	// Variables
+	int i;
+
+	for (i = 0; i < NUM_SHM; i++)
+		if (tabla_shm[i].estado == SHM_NO_USADA)
+			return i;
+
+	// Error
+	return SHM_TABLE_FULL;
+}
+
+/*
+ *
+ * Funciones relacionadas con la tabla de procesos:
+ *	crecer_tabla_proc iniciar_tabla_proc buscar_BCP_libre liberar_BCP
+ *	buscar_BCP_id num_procesos_vivos
+ *
+ */
+
+/*
+ * Función que añade un bloque de entradas a la tabla de procesos,
+ * apilandolas como libres. Devuelve -1 si la tabla ya tiene MAX_TABLA_PROCS.
+ */
+static int crecer_tabla_proc(){
+	int i, bloque;
+
+	if (num_entradas_procs + PROCS_POR_BLOQUE > MAX_TABLA_PROCS)
+		return -1;
+
+	bloque = num_entradas_procs/PROCS_POR_BLOQUE;
+	tabla_procs[bloque] = malloc(PROCS_POR_BLOQUE*sizeof(BCP));
+	if (tabla_procs[bloque] == NULL)
+		return -1;
+
+	for (i=0; i<PROCS_POR_BLOQUE; i++) 
+		tabla_procs[bloque][i] = (BCP) {
+			.estado=NO_USADA,
+			.generacion=0,
+			.mutex_ids ={[0 ... NUM_MUT_PROC-1] = MTX_DESC_NO_USADO},
+			.pipe_ids ={[0 ... NUM_PIPE_PROC-1] = PIPE_DESC_NO_USADO},
+			.cola_ids ={[0 ... NUM_COLA_PROC-1] = COLA_DESC_NO_USADO},
+			.shm_ids ={[0 ... NUM_SHM_PROC-1] = SHM_DESC_NO_USADO}
+		};
+
+	// Se apilan de modo que las entradas menores se usen antes
+	num_entradas_procs += PROCS_POR_BLOQUE;
+	for (i=num_entradas_procs-1; i>=num_entradas_procs-PROCS_POR_BLOQUE; i--)
+		procs_libres[num_procs_libres++] = i;
+
+	return 0;
+}
+
+/*
+ * Funci�n que inicia la tabla de procesos
+ */
+static void iniciar_tabla_proc(){
+	if (crecer_tabla_proc() < 0)
+		panico("no hay memoria para la tabla de procesos");
+}
+
+/*
+ * Funci�n que busca una entrada libre en la tabla de procesos
+ */
+static int buscar_BCP_libre(){
+	if (num_procs_libres == 0 && crecer_tabla_proc() < 0)
+		return -1;
+	return procs_libres[--num_procs_libres];
+}
+
+/*
+ * Función que devuelve una entrada a la pila de libres
+ */
+static void liberar_BCP(BCP *p){
+	// El perfil se conserva hasta aqui para poder leerlo del zombi
+	free(p->perfil);
+	p->perfil = NULL;
+	procs_libres[num_procs_libres++] = ENTRADA_ID(p->id);
+}
+
+/*
+ * Función que devuelve el BCP de un proceso vivo a partir de su id,
+ * NULL si no existe o si el id es de un uso anterior de la entrada.
+ */
+BCP * buscar_BCP_id(int id){
+	BCP *p;
+
+	if (id < 0 || ENTRADA_ID(id) >= num_entradas_procs)
+		return NULL;
+
+	p = BCP_ENTRADA(ENTRADA_ID(id));
+	if (p->estado == NO_USADA || p->id != id)
+		return NULL;
+	return p;
+}
+
+/*
+ * Función que devuelve el numero de entradas ocupadas en la tabla de procesos
+ */
+static int num_procesos_vivos(){
+	return num_entradas_procs - num_procs_libres;
+}
+
+/*
+ *
+ * Funciones relacionadas con la cache de imagenes:
+ *	obtener_imagen soltar_imagen vaciar_cache_imagenes
+ *
+ * NOTA: LA HAL YA DEVUELVE LA MISMA IMAGEN A LAS INSTANCIAS VIVAS DE UN
+ * PROGRAMA, LA CACHE EVITA DESCARGARLA Y RECARGARLA CUANDO TERMINA LA ULTIMA
+ */
+
+/*
+ * Devuelve la imagen del programa, reutilizando la residente si la hay.
+ * En *id se devuelve la entrada de la cache usada.
+ */
+static void * obtener_imagen(char *prog, void **pc_inicial, int *id){
+	void *imagen;
+	int i, libre=-1;
+
+	// Acierto: se reutiliza la imagen residente
+	for (i=0; i<NUM_IMAGENES; i++)
+		if (tabla_imagenes[i].imagen != NULL &&
+			strcmp(tabla_imagenes[i].nombre, prog) == 0) {
+			estad_cache.aciertos++;
+			tabla_imagenes[i].n_refs++;
+			tabla_imagenes[i].ultimo_uso = ++reloj_imagenes;
+			*pc_inicial = tabla_imagenes[i].pc_inicial;
+			*id = i;
+			return tabla_imagenes[i].imagen;
+		}
+
+	// Fallo: se carga el ejecutable
+	estad_cache.fallos++;
+	*id = IMAGEN_NO_CACHEADA;
+	imagen = crear_imagen(prog, pc_inicial);
+	if (imagen == NULL || strlen(prog)+1 > MAX_NOM_PROG)
+		return imagen;
+
+	// Hueco libre o, si no, la imagen sin usar menos reciente
+	for (i=0; i<NUM_IMAGENES; i++) {
+		if (tabla_imagenes[i].imagen == NULL) {
+			libre = i;
+			break;
+		}
+		if (tabla_imagenes[i].n_refs == 0 && (libre == -1 ||
+			tabla_imagenes[i].ultimo_uso < tabla_imagenes[libre].ultimo_uso))
+			libre = i;
+	}
+	if (libre == -1)
+		return imagen;	/* todas en uso: no se cachea */
+
+	if (tabla_imagenes[libre].imagen != NULL) {
+		printk("[%f] \tSE EXPULSA DE LA CACHE LA IMAGEN DE %s\n", (float) t_ticks/TICK, tabla_imagenes[libre].nombre);
+		estad_cache.expulsiones++;
+		liberar_imagen(tabla_imagenes[libre].imagen);
+	} else
+		estad_cache.residentes++;
+
+	strcpy(tabla_imagenes[libre].nombre, prog);
+	tabla_imagenes[libre].imagen = imagen;
+	tabla_imagenes[libre].pc_inicial = *pc_inicial;
+	tabla_imagenes[libre].n_refs = 1;
+	tabla_imagenes[libre].ultimo_uso = ++reloj_imagenes;
+	*id = libre;
+
+	return imagen;
+}
+
+/*
+ * Deja de usar la imagen de un proceso. Si esta en la cache queda
+ * residente para futuras creaciones del mismo programa.
+ */
+static void soltar_imagen(BCP *p){
+	if (p->imagen_id == IMAGEN_NO_CACHEADA)
+		liberar_imagen(p->info_mem);
+	else
+		tabla_imagenes[p->imagen_id].n_refs--;
+}
+
+/*
+ * Libera las imagenes residentes que no usa ningun proceso. 
+ * NOTA: LA HAL APAGA EL SISTEMA AL LIBERAR LA ULTIMA IMAGEN
+ */
+static void vaciar_cache_imagenes(){
+	void *imagen;
+	int i;
+
+	for (i=0; i<NUM_IMAGENES; i++)
+		if (tabla_imagenes[i].imagen != NULL && tabla_imagenes[i].n_refs == 0) {
+			estad_cache.residentes--;
+			imagen = tabla_imagenes[i].imagen;
+			tabla_imagenes[i].imagen = NULL;
+			liberar_imagen(imagen);
+		}
+}
+
+/*
+ *
+ * Funciones relacionadas con el pool de pilas:
+ *	iniciar_pool_pilas obtener_pila soltar_pila
+ *
+ */
+
+/*
+ * Reserva las pilas iniciales del pool
+ */
+static void iniciar_pool_pilas(){
+	void *pila;
+	int i;
+
+	for (i=0; i<NUM_PILAS_INICIALES; i++) {
+		pila=crear_pila(TAM_PILA);
+		*(void **)pila=pool_pilas;
+		pool_pilas=pila;
+		estad_pool.libres++;
+	}
+}
+
+/*
+ * Devuelve una pila del pool, creandola si no quedan libres
+ */
+static void * obtener_pila(){
+	void *pila=pool_pilas;
+
+	if (pila == NULL) {
+		estad_pool.fallos++;
+		return crear_pila(TAM_PILA);
+	}
+
+	estad_pool.aciertos++;
+	estad_pool.libres--;
+	pool_pilas=*(void **)pila;
+	return pila;
+}
+
+/*
+ * Devuelve una pila al pool si no supera el maximo de pilas libres.
+ * NOTA: LA PILA DEL PROCESO QUE TERMINA SE SIGUE USANDO HASTA EL CAMBIO
+ * DE CONTEXTO, PERO SOLO SE REUTILIZA AL CREAR OTRO PROCESO DESPUES
+ */
+static void soltar_pila(void *pila){
+	if (estad_pool.libres >= MAX_PILAS_LIBRES) {
+		liberar_pila(pila);
+		return;
+	}
+
+	*(void **)pila=pool_pilas;
+	pool_pilas=pila;
+	estad_pool.libres++;
+}
+
+/*
+ *
+ * Funciones que facilitan el manejo de las listas de BCPs
+ *	insertar_ultimo eliminar_primero eliminar_elem en_lista
+ *
+ * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
+ */
+
+/*
+ * Inserta un BCP al final de la lista.
+ */
+static void insertar_ultimo(lista_BCPs *lista, BCP * proc){
+	if (lista->primero==NULL)
+		lista->primero= proc;
+	else
+		lista->ultimo->siguiente=proc;
+	lista->ultimo= proc;
+	proc->siguiente=NULL;
+}
+
+/*
+ * Elimina el primer BCP de la lista.
+ */
+static void eliminar_primero(lista_BCPs *lista){
+
+	if (lista->ultimo==lista->primero)
+		lista->ultimo=NULL;
+	lista->primero=lista->primero->siguiente;
+}
+
+/*
+ * Elimina un determinado BCP de la lista.
+ */
+static void eliminar_elem(lista_BCPs *lista, BCP * proc){
+	BCP *paux=lista->primero;
+
+	if (paux==proc)
+		eliminar_primero(lista);
+	else {
+		for ( ; ((paux) && (paux->siguiente!=proc));
+			paux=paux->siguiente);
+		if (paux) {
+			if (lista->ultimo==paux->siguiente)
+				lista->ultimo=paux;
+			paux->siguiente=paux->siguiente->siguiente;
+		}
+	}
+}
+
+/*
+ * Indica si un BCP esta en la lista.
+ */
+static int en_lista(lista_BCPs *lista, BCP * proc){
+	BCP *paux;
+
+	for (paux=lista->primero; paux; paux=paux->siguiente)
+		if (paux==proc)
+			return 1;
+	return 0;
+}
+
+/*
+ *
+ * Funciones de las clases de planificacion (tipo clase_planif):
+ *	rr_* turno rotatorio FIFO (por defecto)
+ *	cfs_* reparto proporcional por vruntime sobre un monticulo
+ *	tr_* procesos periodicos por plazo mas proximo (EDF)
+ *
+ * NOTA: LOS PROCESOS PERIODICOS (periodo > 0) SON DE LA CLASE tr Y TIENEN
+ * PRIORIDAD SOBRE LOS DEMAS, QUE SON DE LA CLASE NORMAL ELEGIDA EN EL
+ * ARRANQUE (clase_normal). EL PROCESO EN EJECUCION SIGUE EN SU COLA HASTA
+ * QUE SE LLAMA A siguiente_rodaja. SE DEBEN LLAMAR CON LAS INTERRUPCIONES
+ * INHIBIDAS
+ */
+
+/*
+ * Turno rotatorio: los listos van en lista_listos por orden de llegada
+ * y el que ejecuta se expulsa al agotar TICKS_POR_RODAJA.
+ */
+static void rr_encolar(BCP * proc){
+	insertar_ultimo(&lista_listos, proc);
+}
+
+static void rr_desencolar(BCP * proc){
+	eliminar_elem(&lista_listos, proc);
+}
+
+static BCP * rr_elegir(){
+	return lista_listos.primero;
+}
+
+static int rr_tick(BCP * proc){
+	return t_proc >= TICKS_POR_RODAJA;
+}
+
+static void rr_ceder(BCP * proc){
+	/* basta con volver a encolarlo al final */
+}
+
+/*
+ * CFS: los listos van en un monticulo ordenado por vruntime, que crece
+ * con cada tick de ejecucion en proporcion inversa al peso del nice.
+ * Se ejecuta siempre el de menor vruntime.
+ */
+
+/*
+ * Intercambia dos posiciones del monticulo manteniendo pos_heap
+ */
+static void heap_intercambiar(int i, int j){
+	BCP *aux = heap_cfs[i];
+
+	heap_cfs[i] = heap_cfs[j];
+	heap_cfs[j] = aux;
+	heap_cfs[i]->pos_heap = i;
+	heap_cfs[j]->pos_heap = j;
+}
+
+/*
+ * Sube un elemento mientras tenga menos vruntime que su padre
+ */
+static void heap_subir(int i){
+	while (i > 0 && heap_cfs[i]->vruntime < heap_cfs[(i-1)/2]->vruntime) {
+		heap_intercambiar(i, (i-1)/2);
+		i = (i-1)/2;
+	}
+}
+
+/*
+ * Baja un elemento mientras tenga mas vruntime que alguno de sus hijos
+ */
+static void heap_bajar(int i){
+	int menor;
+
+	for (;;) {
+		menor = i;
+		if (2*i+1 < num_heap_cfs && heap_cfs[2*i+1]->vruntime < heap_cfs[menor]->vruntime)
+			menor = 2*i+1;
+		if (2*i+2 < num_heap_cfs && heap_cfs[2*i+2]->vruntime < heap_cfs[menor]->vruntime)
+			menor = 2*i+2;
+		if (menor == i)
+			return;
+		heap_intercambiar(i, menor);
+		i = menor;
+	}
+}
+
+/*
+ * Un proceso nuevo o expulsado no puede quedar por detras de min_vruntime
+ */
+static void cfs_encolar(BCP * proc){
+	if (proc->vruntime < min_vruntime)
+		proc->vruntime = min_vruntime;
+	proc->pos_heap = num_heap_cfs;
+	heap_cfs[num_heap_cfs++] = proc;
+	heap_subir(proc->pos_heap);
+}
+
+static void cfs_desencolar(BCP * proc){
+	int i = proc->pos_heap;
+
+	if (--num_heap_cfs == i)
+		return;
+	heap_intercambiar(i, num_heap_cfs);
+	heap_subir(i);
+	heap_bajar(heap_cfs[i]->pos_heap);
+}
+
+static BCP * cfs_elegir(){
+	return (num_heap_cfs > 0) ? heap_cfs[0] : NULL;
+}
+
+/*
+ * Carga el tick al vruntime segun el peso; tras la granularidad minima
+ * se expulsa si otro lleva menos vruntime
+ */
+static int cfs_tick(BCP * proc){
+	proc->vruntime += VR_POR_TICK*PESO_NICE_0/pesos_nice[proc->nice - NICE_MIN];
+	heap_bajar(proc->pos_heap);
+	if (heap_cfs[0]->vruntime > min_vruntime)
+		min_vruntime = heap_cfs[0]->vruntime;
+
+	return t_proc >= GRANULARIDAD_MIN && heap_cfs[0] != proc;
+}
+
+/*
+ * Tras un bloqueo no conserva mas credito que BONO_DESPERTAR
+ */
+static void cfs_despertar(BCP * proc){
+	if (proc->vruntime + BONO_DESPERTAR < min_vruntime)
+		proc->vruntime = min_vruntime - BONO_DESPERTAR;
+	proc->pos_heap = num_heap_cfs;
+	heap_cfs[num_heap_cfs++] = proc;
+	heap_subir(proc->pos_heap);
+}
+
+/*
+ * Se coloca detras del siguiente de menor vruntime (sigue en el monticulo)
+ */
+static void cfs_ceder(BCP * proc){
+	unsigned long long siguiente;
+	int i;
+
+	if (proc->pos_heap != 0)
+		siguiente = heap_cfs[0]->vruntime;
+	else if (num_heap_cfs > 1) {
+		i = (num_heap_cfs > 2 && heap_cfs[2]->vruntime < heap_cfs[1]->vruntime) ? 2 : 1;
+		siguiente = heap_cfs[i]->vruntime;
+	}
+	else
+		return;
+
+	if (proc->vruntime <= siguiente)
+		proc->vruntime = siguiente + 1;
+}
+
+/*
+ * EDF: los periodicos van en lista_tr ordenada por plazo absoluto. Al
+ * llegar uno con plazo anterior al del que ejecuta, lo expulsa. Solo
+ * ceden el procesador en esperar_periodo.
+ */
+
+/*
+ * Inserta un BCP en la lista ordenada por plazo absoluto (t_plazo),
+ * detras de los de igual plazo.
+ */
+static void insertar_por_plazo(lista_BCPs *lista, BCP * proc){
+	BCP *paux=lista->primero;
+
+	if (paux==NULL || proc->t_plazo < paux->t_plazo) {
+		proc->siguiente=paux;
+		lista->primero=proc;
+		if (paux==NULL)
+			lista->ultimo=proc;
+		return;
+	}
+	for ( ; paux->siguiente && paux->siguiente->t_plazo <= proc->t_plazo;
+		paux=paux->siguiente);
+	proc->siguiente=paux->siguiente;
+	paux->siguiente=proc;
+	if (lista->ultimo==paux)
+		lista->ultimo=proc;
+}
+
+static void tr_encolar(BCP * proc){
+	insertar_por_plazo(&lista_tr, proc);
+	if (p_proc_actual != NULL && p_proc_actual != proc &&
+		p_proc_actual->estado == EJECUCION &&
+		(p_proc_actual->periodo == 0 || proc->t_plazo < p_proc_actual->t_plazo)) {
+		p_proc_actual->estado = LISTO;
+		activar_int_SW();
+	}
+}
+
+static void tr_desencolar(BCP * proc){
+	eliminar_elem(&lista_tr, proc);
+}
+
+static BCP * tr_elegir(){
+	return lista_tr.primero;
+}
+
+static int tr_tick(BCP * proc){
+	return 0;
+}
+
+static void tr_ceder(BCP * proc){
+}
+
+static clase_planif clase_rr =
+	{"RR", rr_encolar, rr_desencolar, rr_elegir, rr_tick, rr_encolar, rr_ceder};
+static clase_planif clase_cfs =
+	{"CFS", cfs_encolar, cfs_desencolar, cfs_elegir, cfs_tick, cfs_despertar, cfs_ceder};
+static clase_planif clase_tr =
+	{"EDF", tr_encolar, tr_desencolar, tr_elegir, tr_tick, tr_encolar, tr_ceder};
+
+/* clases que se pueden elegir para los procesos no periodicos */
+static clase_planif *clases_normales[] = {&clase_rr, &clase_cfs, NULL};
+
+/*
+ * Elige en el arranque la clase de los procesos no periodicos segun la
+ * variable de entorno PLANIFICADOR (turno rotatorio si no esta definida).
+ */
+static void iniciar_planificador(){
+	char *nombre = getenv("PLANIFICADOR");
+	int i;
+
+	clase_normal = &clase_rr;
+	if (nombre != NULL) {
+		for (i=0; clases_normales[i] != NULL && strcmp(clases_normales[i]->nombre, nombre) != 0; i++);
+		if (clases_normales[i] != NULL)
+			clase_normal = clases_normales[i];
+		else
+			printk("-> PLANIFICADOR %s DESCONOCIDO, SE USA %s\n", nombre, clase_normal->nombre);
+	}
+	printk("-> PLANIFICADOR %s\n", clase_normal->nombre);
+}
+
+/*
+ *
+ * Funciones relacionadas con las colas de listos, que delegan en la
+ * clase de cada proceso:
+ *	encolar_listo despertar_listo desencolar_listo primero_listo
+ *
+ */
+
+#define CLASE(p) ((p)->periodo != 0 ? &clase_tr : clase_normal)
+
+/*
+ * Pone un proceso nuevo o expulsado en la cola de su clase.
+ */
+static void encolar_listo(BCP * proc){
+	CLASE(proc)->encolar(proc);
+	n_ejecutables++;
+}
+
+/*
+ * Pone un proceso que estaba bloqueado en la cola de su clase.
+ */
+static void despertar_listo(BCP * proc){
+	CLASE(proc)->despertar(proc);
+	n_ejecutables++;
+}
+
+/*
+ * Saca un proceso de la cola de listos de su clase.
+ */
+static void desencolar_listo(BCP * proc){
+	CLASE(proc)->desencolar(proc);
+	n_ejecutables--;
+}
+
+/*
+ * Devuelve el proceso listo que toca ejecutar (NULL si no hay ninguno):
+ * el de la clase de periodicos o, si no hay, el de la clase normal.
+ */
+static BCP * primero_listo(){
+	BCP *p = clase_tr.elegir();
+
+	return (p != NULL) ? p : clase_normal->elegir();
+}
+
+/*
+ * Despierta al primer BCP almacenado en una lista cambiando su estado,
+ * pasandolo a la lista de listos y eliminandolo de la lista actual.
+ */
+static void despierta_primero(lista_BCPs *lista){
+
+	// Variables
+	BCPptr p;
+	int n_int;
+
+	p = lista->primero;
+	if (p != NULL) {
+		// Cambiamos su estado
+		p->estado = LISTO;
+
+		// Inhibir interrupciones
+		n_int = fijar_nivel_int(NIVEL_3);
+
+		// Modificar listas de BCPs
+		eliminar_elem(lista,p);
+		despertar_listo(p);
+
+		// Deshinibir interrupciones
+		fijar_nivel_int(n_int);
+	}
+}
+
+/*
+ * Despierta a todos los BCPs almacenados en una lista.
+ */
+static void despierta_todos(lista_BCPs *lista){
+	while (lista->primero != NULL)
+		despierta_primero(lista);
+}
+
+/*
+ * Despierta a los BCPs de una lista cuyo plazo de espera (t_limite)
+ * ha vencido.
+ */
+static void despierta_vencidos(lista_BCPs *lista){
+
+	// Variables
+	BCPptr p = lista->primero, p_next;
+	int n_int;
+
+	while (p != NULL) {
+
+		// Reservamos el valor del siguiente
+		p_next = p->siguiente;
+
+		if (p->t_limite != 0 && p->t_limite <= t_ticks) {
+			printk("[%f] \tPROCESO %d AGOTA SU PLAZO DE ESPERA\n", (float) t_ticks/TICK, p->id);
+
+			// Cambiamos su estado
+			p->estado = LISTO;
+
+			// Inhibir interrupciones
+			n_int = fijar_nivel_int(NIVEL_3);
+
+			// Modificar listas de BCPs
+			eliminar_elem(lista,p);
+			despertar_listo(p);
+
+			// Deshinibir interrupciones
+			fijar_nivel_int(n_int);
+		}
+
+		// Avanzamos el puntero
+		p = p_next;
+	}
+}
+
+/*
+ *
+ * Funciones relacionadas con las cuotas de procesador
+ *	renovar_cuota cargar_cuota libera_estrangulado libera_estrangulados_vencidos
+ *
+ */
+
+/*
+ * Si ha vencido el periodo de cuota del proceso, empieza el que
+ * contiene al tick actual con el consumo a cero.
+ */
+static void renovar_cuota(BCP * proc){
+	if (proc->t_fin_cuota > t_ticks)
+		return;
+	proc->consumo_cuota = 0;
+	proc->t_fin_cuota += proc->periodo_cuota*((t_ticks - proc->t_fin_cuota)/proc->periodo_cuota + 1);
+}
+
+/*
+ * Carga un tick a la cuota del proceso. Devuelve 1 si la ha agotado.
+ */
+static int cargar_cuota(BCP * proc){
+	renovar_cuota(proc);
+	proc->consumo_total++;
+	return ++proc->consumo_cuota >= proc->cuota;
+}
+
+/*
+ * Saca a un proceso de la cola de estrangulados y lo pasa a listo.
+ */
+static void libera_estrangulado(BCP * proc){
+
+	// Variables
+	int n_int;
+
+	printk("[%f] \tPROCESO %d RECUPERA SU CUOTA\n", (float) t_ticks/TICK, proc->id);
+
+	// Cambiamos su estado
+	proc->estado = LISTO;
+	proc->ticks_estrangulado += t_ticks - proc->t_estrangulado;
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Modificar listas de BCPs
+	eliminar_elem(&lista_estrangulados, proc);
+	despertar_listo(proc);
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+}
+
+/*
+ * Libera a los estrangulados cuyo periodo de cuota ha vencido.
+ */
+static void libera_estrangulados_vencidos(){
+
+	// Variables
+	BCPptr p = lista_estrangulados.primero, p_next;
+
+	while (p != NULL) {
+
+		// Reservamos el valor del siguiente
+		p_next = p->siguiente;
+
+		if (p->t_fin_cuota <= t_ticks) {
+			renovar_cuota(p);
+			libera_estrangulado(p);
+		}
+
+		// Avanzamos el puntero
+		p = p_next;
+	}
+}
+
+/*
+ *
+ * Funciones relacionadas con la planificacion
+ *	espera_int planificador
+ */
+
+/*
+ * Reloj de resolucion menor que el tick para medir la duracion de las
+ * llamadas y dar obtener_tiempo_ns. El HAL no ofrece ninguno, asi que se
+ * usa el reloj monotono de la maquina anfitriona, como se usaria un
+ * contador de ciclos.
+ */
+static unsigned long long reloj_ns(){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long)t.tv_sec*1000000000ULL + t.tv_nsec;
+}
+
+/*
+ *
+ * Funciones relacionadas con la medida de secciones criticas
+ *	cerrar_seccion fijar_nivel_medido
+ *
+ */
+
+/*
+ * Carga a un punto una seccion critica de ns nanosegundos
+ */
+static void cerrar_seccion(seccion_crit *s, unsigned long long ns){
+	unsigned long long us = ns/1000;
+	int c = 0;
+
+	while (us > 0 && c < CUBETAS_SECCION-1) {
+		us >>= 1;
+		c++;
+	}
+	s->veces++;
+	s->ns_total += ns;
+	if (ns > s->ns_max)
+		s->ns_max = ns;
+	s->histograma[c]++;
+
+	if (!s->registrada) {
+		s->registrada = 1;
+		s->siguiente = lista_secciones;
+		lista_secciones = s;
+		n_secciones++;
+	}
+}
+
+/*
+ * Cambia el nivel de interrupcion como fijar_nivel_int del HAL (al que
+ * se llama entre parentesis para no usar la macro) y mide las secciones
+ * criticas: al subir de nivel anota la hora y el punto que lo sube, y
+ * al bajar carga la duracion a ese punto. La hora se toma antes de
+ * llamar al HAL, que es quien dice el nivel anterior. Al bajar puede
+ * entrar una interrupcion antes de anotarlo, pero solo toca niveles
+ * por encima del suyo, y el mas bajo de la seccion sigue abierto.
+ * Los niveles que bajan sin pasar por aqui (vuelta de una interrupcion
+ * o cambio de contexto) se descartan; un cambio de contexto con el
+ * nivel subido cuenta para el punto que lo subio.
+ */
+int fijar_nivel_medido(int nivel, seccion_crit *seccion){
+	int anterior, l;
+	unsigned long long t;
+	seccion_crit *cerrada = NULL;
+
+	t = reloj_ns();
+	anterior = (fijar_nivel_int)(nivel);
+
+	for (l = anterior+1; l <= NUM_NIVELES; l++)
+		seccion_abierta[l] = NULL;
+
+	if (nivel > anterior) {
+		seccion->nivel = nivel;
+		for (l = anterior+1; l <= nivel; l++) {
+			seccion_abierta[l] = seccion;
+			t_seccion[l] = t;
+		}
+	}
+	else
+		for (l = anterior; l > nivel; l--) {
+			if (seccion_abierta[l] != NULL && seccion_abierta[l] != cerrada) {
+				cerrada = seccion_abierta[l];
+				cerrar_seccion(cerrada, t - t_seccion[l]);
+			}
+			seccion_abierta[l] = NULL;
+		}
+
+	return anterior;
+}
+
+/*
+ *
+ * Funciones relacionadas con la pagina de datos del kernel
+ *	iniciar_datos_kernel actualizar_datos_kernel
+ *
+ */
+
+/*
+ * Crea la pagina de datos: una region compartida que se vuelve a
+ * proyectar en otra direccion, que queda de solo lectura. Si no se
+ * puede, los procesos ven la misma proyeccion que el kernel.
+ */
+static void iniciar_datos_kernel(){
+	void *dir, *dir_ro;
+	size_t tam = TAM_PAGINA_DATOS;
+
+	dir = mmap(NULL, tam, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+	if (dir == MAP_FAILED)
+		panico("no se puede crear la pagina de datos del kernel");
+	datos_kernel = dir;
+	datos_usuario = dir;
+
+	dir_ro = mremap(dir, 0, tam, MREMAP_MAYMOVE);
+	if (dir_ro != MAP_FAILED && mprotect(dir_ro, tam, PROT_READ) == 0)
+		datos_usuario = dir_ro;
+	else
+		printk("-> PAGINA DE DATOS DEL KERNEL SIN PROTECCION DE ESCRITURA\n");
+
+	/* origen de obtener_tiempo_ns, que asi no necesita entrar al kernel */
+	datos_kernel->arranque_ns = t_arranque_ns;
+}
+
+/*
+ * Copia en la pagina de datos el reloj, los tiempos del proceso en
+ * ejecucion y, si es un hilo, su funcion y argumento. Se llama en cada
+ * tick y en cada cambio de contexto.
+ */
+static void actualizar_datos_kernel(){
+	int n_int;
+
+	n_int = fijar_nivel_int(NIVEL_3);
+	datos_kernel->secuencia++;
+	datos_kernel->id_actual = p_proc_actual->id;
+	datos_kernel->ticks = t_ticks;
+	datos_kernel->tick_ns = t_tick_ns;
+	datos_kernel->usuario = t_usr;
+	datos_kernel->sistema = t_sys;
+	datos_kernel->proc_usuario = p_proc_actual->ticks_usuario;
+	datos_kernel->proc_sistema = p_proc_actual->ticks_sistema;
+	datos_kernel->funcion_hilo = p_proc_actual->funcion_hilo;
+	datos_kernel->arg_hilo = p_proc_actual->arg_hilo;
+	datos_kernel->secuencia++;
+	fijar_nivel_int(n_int);
+}
+
+/*
+ *
+ * Funciones relacionadas con el perfilador
+ *	tomar_muestra buscar_simbolo
+ *
+ */
+
+/*
+ * Guarda en el perfil del proceso actual el PC de usuario interrumpido
+ * por el reloj. La HAL no lo ofrece, asi que se recorre la pila desde
+ * el tratamiento, que pasa por el marco de la señal, hasta el primer
+ * marco que cae en la imagen del proceso.
+ */
+static void tomar_muestra(){
+	perfil_proceso *perfil = p_proc_actual->perfil;
+	void *marcos[MARCOS_PERFIL];
+	struct link_map *mapa;
+	Dl_info info;
+	int i, n;
+
+	if (perfil->info.muestras == TAM_PERFIL ||
+		dlinfo(p_proc_actual->info_mem, RTLD_DI_LINKMAP, &mapa) != 0) {
+		perfil->info.perdidas++;
+		return;
+	}
+
+	n = backtrace(marcos, MARCOS_PERFIL);
+	for (i = 1; i < n; i++)
+		if (dladdr(marcos[i], &info) && (ElfW(Addr))info.dli_fbase == mapa->l_addr) {
+			perfil->pc[perfil->info.muestras++] = marcos[i];
+			return;
+		}
+	perfil->info.perdidas++;
+}
+
+/*
+ * Busca en la tabla de simbolos del fichero de una imagen la funcion
+ * que contiene el desplazamiento desp (relativo a su base de carga).
+ * Se lee .symtab porque dladdr no ve las funciones static.
+ * Devuelve 0 con su nombre y su inicio, o -1 si no la encuentra.
+ */
+static int buscar_simbolo(const char *fichero, unsigned long desp, char *simbolo, unsigned long *inicio){
+	ElfW(Ehdr) *elf;
+	ElfW(Shdr) *secc;
+	ElfW(Sym) *sim;
+	struct stat st;
+	char *nombres;
+	FILE *f;
+	int i, j, n, res = -1;
+
+	if ((f = fopen(fichero, "r")) == NULL)
+		return -1;
+	if (fstat(fileno(f), &st) < 0 || st.st_size < sizeof(ElfW(Ehdr)) ||
+		(elf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0)) == MAP_FAILED) {
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	if (memcmp(elf->e_ident, ELFMAG, SELFMAG) != 0 ||
+		elf->e_shoff + elf->e_shnum*sizeof(ElfW(Shdr)) > st.st_size) {
+		munmap(elf, st.st_size);
+		return -1;
+	}
+
+	secc = (ElfW(Shdr) *)((char *)elf + elf->e_shoff);
+	for (i = 0; i < elf->e_shnum && res < 0; i++) {
+		if (secc[i].sh_type != SHT_SYMTAB || secc[i].sh_link >= elf->e_shnum ||
+			secc[i].sh_offset + secc[i].sh_size > st.st_size)
+			continue;
+		sim = (ElfW(Sym) *)((char *)elf + secc[i].sh_offset);
+		nombres = (char *)elf + secc[secc[i].sh_link].sh_offset;
+		n = secc[i].sh_size/sizeof(ElfW(Sym));
+		for (j = 0; j < n; j++)
+			if (ELF64_ST_TYPE(sim[j].st_info) == STT_FUNC && sim[j].st_value <= desp &&
+				desp < sim[j].st_value + sim[j].st_size) {
+				strncpy(simbolo, nombres + sim[j].st_name, TAM_SIMBOLO-1);
+				simbolo[TAM_SIMBOLO-1] = '\0';
+				*inicio = sim[j].st_value;
+				res = 0;
+				break;
+			}
+	}
+
+	munmap(elf, st.st_size);
+	return res;
+}
+
+/*
+ * Espera a que se produzca una interrupcion
+ */
+static void espera_int(){
+	int nivel;
+
+	printk("[%f] \tNO HAY LISTOS. ESPERA INT\n", (float) t_ticks/TICK);
+
+	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
+	nivel=fijar_nivel_int(NIVEL_1);
+	halt();
+	fijar_nivel_int(nivel);
+}
+
+/*
+ * Funcin de planificacion: elige al primer listo de la clase de los
+ * periodicos (EDF) o, si no hay, de la clase normal (FIFO por defecto).
+ */
+static BCP * planificador(){
+	while (primero_listo()==NULL)
+		espera_int();		/* No hay nada que hacer */
+	return primero_listo();
+}
+
+/*
+ * Función que realiza el cambio de contexto al proceso 
+ * de la siguiente rodaja
+ */
+static void siguiente_rodaja() {
+
+	// Variables
+	BCPptr old_p, p_padre;
+	int n_int, voluntario;
+	unsigned long long t_salida;
+
+	printk("[%f] \tSIGUIENTE RODAJA\n", (float) t_ticks/TICK);
+
+	// Reestablecemos el contador de la rodaja
+	t_proc = 0;
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Modificar listas de BCPs
+	old_p = p_proc_actual;
+	voluntario = cesion;
+	cesion = 0;
+	desencolar_listo(p_proc_actual);
+
+	// Casuisticas de un proceso
+	switch (p_proc_actual->estado) {
+		case LISTO:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE LISTOS\n", (float) t_ticks/TICK, sis_obtener_id_pr());
+			encolar_listo(p_proc_actual);
+			break;
+		case DORMIDO:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS\n", (float) t_ticks/TICK, sis_obtener_id_pr());
+			insertar_ultimo(&lista_dormidos, p_proc_actual);
+			break;
+		case BLOQUEADO:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE UN DESCRIPTOR LIBRE\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr());
+			insertar_ultimo(&lista_bloqueados_mtx, p_proc_actual);
+			break;
+		case BLOQUEADO_MTX:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE LIBERAR EL MUTEX %d (%s)\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), (int)leer_registro(1), tabla_mutex[(int)leer_registro(1)].nombre);
+			insertar_ultimo(&tabla_mutex[(int)leer_registro(1)].lista_bloqueados, p_proc_actual);
+			break;
+		case BLOQUEADO_TERM:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE LEER UN CARACTER\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr());
+			insertar_ultimo(&lista_bloqueados_term, p_proc_actual);
+			break;
+		case BLOQUEADO_PIPE_LEC:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE LEER DEL PIPE %d\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), pipe_desc_id((int)leer_registro(1)));
+			insertar_ultimo(&tabla_pipes[pipe_desc_id((int)leer_registro(1))].lista_lectores, p_proc_actual);
+			break;
+		case BLOQUEADO_PIPE_ESC:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE ESCRIBIR EN EL PIPE %d\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), pipe_desc_id((int)leer_registro(1)));
+			insertar_ultimo(&tabla_pipes[pipe_desc_id((int)leer_registro(1))].lista_escritores, p_proc_actual);
+			break;
+		case BLOQUEADO_COLA_REC:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE RECIBIR DE LA COLA %d (%s)\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), (int)leer_registro(1), tabla_colas[(int)leer_registro(1)].nombre);
+			insertar_ultimo(&tabla_colas[(int)leer_registro(1)].lista_receptores, p_proc_actual);
+			break;
+		case BLOQUEADO_COLA_ENV:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE ENVIAR A LA COLA %d (%s)\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), (int)leer_registro(1), tabla_colas[(int)leer_registro(1)].nombre);
+			insertar_ultimo(&tabla_colas[(int)leer_registro(1)].lista_emisores, p_proc_actual);
+			break;
+		case ZOMBI:
+			printk("[%f] \tPROCESO %d QUEDA ZOMBI HASTA QUE LO ESPERE SU PADRE %d\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), p_proc_actual->padre);
+			p_padre = buscar_BCP_id(p_proc_actual->padre);
+			insertar_ultimo(&p_padre->lista_zombis, p_proc_actual);
+			break;
+		case BLOQUEADO_HIJO:
+			printk("[%f] \tPROCESO %d PASA A LA COLA DE DORMIDOS A LA ESPERA DE UN HIJO\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr());
+			insertar_ultimo(&p_proc_actual->lista_esperando, p_proc_actual);
+			break;
+		case ESTRANGULADO:
+			printk("[%f] \tPROCESO %d AGOTA SU CUOTA HASTA EL TICK %u\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), p_proc_actual->t_fin_cuota);
+			p_proc_actual->n_estrangulamientos++;
+			p_proc_actual->t_estrangulado = t_ticks;
+			insertar_ultimo(&lista_estrangulados, p_proc_actual);
+			break;
+		default:
+			break;
+	}
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	// Se cuentan las veces que deja el procesador por bloquearse
+	if (old_p->estado != LISTO && old_p->estado != ESTRANGULADO &&
+		old_p->estado != TERMINADO && old_p->estado != ZOMBI)
+		old_p->n_bloqueos++;
+
+	// Invocar planificador para obtener nuevo proceso
+	t_salida = reloj_ns();
+	p_proc_actual = planificador();
+	p_proc_actual->estado = EJECUCION;
+	actualizar_datos_kernel();
+
+	// Si es el unico proceso en el sistema, se duerme y se despierta no se deberia hacer c. contexto
+	if (old_p->id != p_proc_actual->id) {
+		if (old_p->estado == TERMINADO || old_p->estado == ZOMBI) {
+			printk("[%f] \tC.CONTEXTO POR FIN:", (float) t_ticks/TICK);
+			estad_sistema.cambios_fin++;
+		}
+		else if (voluntario || (old_p->estado != LISTO && old_p->estado != ESTRANGULADO)) {
+			printk("[%f] \tC.CONTEXTO VOLUNTARIO:", (float) t_ticks/TICK);
+			estad_sistema.cambios_voluntarios++;
+		}
+		else {
+			printk("[%f] \tC.CONTEXTO INVOLUNTARIO:", (float) t_ticks/TICK);
+			estad_sistema.cambios_involuntarios++;
+		}
+		printk("%d a %d\n", old_p->id, p_proc_actual->id);
+
+		// Cambio de contexto
+		if (old_p->estado == TERMINADO || old_p->estado == ZOMBI)
+			cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+		else
+			cambio_contexto(&(old_p->contexto_regs), &(p_proc_actual->contexto_regs));
+	}
+
+	// Vuelve a ejecutar: se anota el tiempo que ha estado sin procesador
+	old_p->ns_fuera += reloj_ns() - t_salida;
+}
+
+/*
+ *
+ * Funcion auxiliar que termina proceso actual liberando sus recursos.
+ * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ *
+ */
+static void liberar_proceso(){
+
+	// Variables
+	int i, n_int;
+	BCPptr p_hijo, p_padre, p_init;
+
+	// Cerrando mutexes que tenga asociados
+	for (i = 0; i < NUM_MUT_PROC; i++){
+		if (p_proc_actual->mutex_ids[i] != MTX_DESC_NO_USADO){
+			escribir_registro(1, p_proc_actual->mutex_ids[i]);
+			sis_cerrar_mutex();
+		}
+		p_proc_actual->mutex_ids[i] = MTX_DESC_NO_USADO;
+	}
+
+	// Cerrando colas de mensajes que tenga asociadas
+	for (i = 0; i < NUM_COLA_PROC; i++){
+		if (p_proc_actual->cola_ids[i] != COLA_DESC_NO_USADO){
+			escribir_registro(1, p_proc_actual->cola_ids[i]);
+			sis_cerrar_cola();
+		}
+	}
+
+	// Liberando los buffers de mensajes grandes que posea
+	for (i = 0; i < NUM_BUF_MSJ; i++)
+		if (tabla_buffers[i].datos != NULL && tabla_buffers[i].dueno == p_proc_actual->id)
+			eliminar_buffer(i);
+
+	// Cerrando regiones de memoria compartida que tenga asociadas
+	for (i = 0; i < NUM_SHM_PROC; i++){
+		if (p_proc_actual->shm_ids[i] != SHM_DESC_NO_USADO){
+			escribir_registro(1, p_proc_actual->shm_ids[i]);
+			sis_cerrar_memoria_compartida();
+		}
+	}
+
+	// Cerrando pipes que tenga asociados
+	for (i = 0; i < NUM_PIPE_PROC; i++){
+		if (p_proc_actual->pipe_ids[i] != PIPE_DESC_NO_USADO){
+			escribir_registro(1, i);
+			sis_cerrar_pipe();
+		}
+	}
+
+	// Un acceso a parametros interrumpido por una excepcion no llega a terminar
+	acc_param = 0;
+
+	// El mapa se libera con el ultimo hilo que lo comparte
+	if (p_proc_actual->refs_imagen == NULL)
+		soltar_imagen(p_proc_actual); /* liberar mapa */
+	else if (--*p_proc_actual->refs_imagen == 0) {
+		free(p_proc_actual->refs_imagen);
+		soltar_imagen(p_proc_actual); /* liberar mapa */
+	}
+	soltar_pila(p_proc_actual->pila); /* liberar pila */
+	utilizacion_tr -= p_proc_actual->densidad; /* liberar reserva EDF */
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Los hijos terminados que no ha esperado ya no los esperara nadie
+	while ((p_hijo = p_proc_actual->lista_zombis.primero) != NULL) {
+		eliminar_primero(&p_proc_actual->lista_zombis);
+		p_hijo->estado=TERMINADO;
+		liberar_BCP(p_hijo);
+	}
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	// Los hijos vivos los adopta init, que puede esperarlos
+	p_init = buscar_BCP_id(id_init);
+	if (p_proc_actual->n_hijos > 0 && p_init != NULL && p_init != p_proc_actual &&
+			p_init->estado != ZOMBI)
+		for (i = 0; i < num_entradas_procs; i++) {
+			p_hijo = BCP_ENTRADA(i);
+			if (p_hijo->estado != NO_USADA && p_hijo->estado != TERMINADO &&
+					p_hijo->padre == p_proc_actual->id) {
+				p_hijo->padre = id_init;
+				p_init->n_hijos++;
+			}
+		}
+
+	// Con el padre vivo queda zombi hasta que lo espere (los ids no se
+	// repiten, asi que un padre ya liberado no se encuentra)
+	p_padre = buscar_BCP_id(p_proc_actual->padre);
+	if (p_padre != NULL && p_padre->estado != ZOMBI) {
+		p_proc_actual->estado=ZOMBI;
+		despierta_todos(&p_padre->lista_esperando);
+	}
+	else {
+		p_proc_actual->estado=TERMINADO;
+		liberar_BCP(p_proc_actual);
+	}
+
+	// Sin procesos vivos se descargan las imagenes residentes (y la HAL apaga el sistema)
+	if (num_procesos_vivos() == 0)
+		vaciar_cache_imagenes();
+
+	// Siguiente proceso
+	siguiente_rodaja();
+
+    return; /* no deber�a llegar aqui */
+}
+
+/*
+ *
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
+ *
+ */
+
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit(){
+
+	estad_sistema.interrupciones[EXC_ARITM]++;
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
+
+	printk("[%f] \tEXCEPCION ARITMETICA EN PROC %d\n", (float) t_ticks/TICK, p_proc_actual->id);
+	p_proc_actual->estado_fin = FIN_POR_EXCEPCION;
+	liberar_proceso();
+
+        return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem(){
+
+	estad_sistema.interrupciones[EXC_MEM]++;
+
+	if (!viene_de_modo_usuario() && acc_param == 0)
+		panico("excepcion de memoria cuando estaba dentro del kernel");
+
+	printk("[%f] \tEXCEPCION DE MEMORIA EN PROC %d\n", (float) t_ticks/TICK, p_proc_actual->id);
+	p_proc_actual->estado_fin = FIN_POR_EXCEPCION;
+	liberar_proceso();
+
+    return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de interrupciones de terminal
+ */
+static void int_terminal(){
+
+	// Variables
+	int n_int;
+	char car;
+
+	// Impedimos c. de contexto involuntarios por int sw
+	n_int = fijar_nivel_int(NIVEL_1);
+
+	estad_sistema.interrupciones[INT_TERMINAL]++;
+	car = leer_puerto(DIR_TERMINAL);
+
+	// Almacenamos el caracter si hay hueco en el buffer
+	if (read_chars - start_char < TAM_BUF_TERM) {
+		char_buff[read_chars % TAM_BUF_TERM] = car;
+		read_chars++;
+	}
+
+	printk("[%f] \tTRATANDO INT. DE TERMINAL %c CARACTERES LEIDOS %d\n", 
+		(float) t_ticks/TICK, car, read_chars - start_char);
+
+	// Reestablecemos el nivel de ejecucion
+	fijar_nivel_int(n_int);
+
+	// Despertando proceso bloqueado a la espera de leer un carcter si los hay
+	despierta_primero(&lista_bloqueados_term);
+
+    return;
+}
+
+/*
+ * Actualiza las medias de carga con el numero de ejecutables de este
+ * tick: media = media*decae + ejecutables*(1-decae), en coma fija
+ */
+static void actualizar_carga(){
+	static const unsigned long long decae[3] =
+		{DECAE_CARGA_1, DECAE_CARGA_5, DECAE_CARGA_15};
+	unsigned long long n;
+	int i;
+
+	// Un contador negativo seria un error de cuenta: no debe disparar la media
+	n = (n_ejecutables > 0) ? (unsigned long long)n_ejecutables << BITS_CARGA : 0;
+
+	for (i = 0; i < 3; i++)
+		carga_fija[i] = (carga_fija[i]*decae[i] + n*(UNO_CARGA - decae[i])) >> BITS_CARGA;
+}
+
+/*
+ * Tratamiento de interrupciones de reloj
+ */
+static void int_reloj(){
+
+	// Variables
+	BCPptr p = lista_dormidos.primero, p_next;
+	unsigned int n_int;
+	int i;
+
+	// Incrementamos el numero de ticks actuales del kernel
+	t_ticks++;
+	t_tick_ns = reloj_ns() - t_arranque_ns;
+	estad_sistema.interrupciones[INT_RELOJ]++;
+
+	// Gestion de tiempos si hay procesos activos
+	if (primero_listo() != NULL) {
+		if (viene_de_modo_usuario()) {
+			t_usr++;
+			p_proc_actual->ticks_usuario++;
+			if (p_proc_actual->perfil != NULL && p_proc_actual->perfil->info.activo)
+				tomar_muestra();
+		}
+		else {
+			t_sys++;
+			p_proc_actual->ticks_sistema++;
+			if (p_proc_actual->perfil != NULL && p_proc_actual->perfil->info.activo)
+				p_proc_actual->perfil->info.sistema++;
+		}
+		// Si el proceso no actua como el nulo, esta consumiendo su rodaja
+		t_proc++;
+	}
+	else
+		estad_sistema.ticks_ociosos++;
+	actualizar_carga();
+	actualizar_datos_kernel();
+
+	printk("[%f] \tTRATANDO INT. DE RELOJ (TIEMPO RESTANTE DE RODAJA: %d)\n", 
+	 	(float) t_ticks/TICK, TICKS_POR_RODAJA - t_proc);
+
+	// Tratando procesos esperando un plazo
+	while (p != NULL) {
+
+		// Reservamos el valor del siguiente
+		p_next = p->siguiente;
+
+		// Si se cumple el plazo, desbloqueamos el proceso
+		if (p->t_wake <= t_ticks) {
+			printk("[%f] \tPROCESO %d LISTO\n", (float) t_ticks/TICK, p->id);
+
+			// Cambiamos su estado
+			p->estado = LISTO;
+
+			// Inhibir interrupciones
+			n_int = fijar_nivel_int(NIVEL_3);
+
+			// Modificar listas de BCPs
+			eliminar_elem(&lista_dormidos,p);
+			despertar_listo(p);
+
+			// Deshinibir interrupciones
+			fijar_nivel_int(n_int);
+		}
+
+		// Avanzamos el puntero
+		p = p_next;
+	}
+
+	// Tratando procesos esperando en una cola de mensajes con plazo
+	for (i = 0; i < NUM_COLAS; i++)
+		if (tabla_colas[i].estado != COLA_NO_USADA) {
+			despierta_vencidos(&tabla_colas[i].lista_receptores);
+			despierta_vencidos(&tabla_colas[i].lista_emisores);
+		}
+
+	// Tratando procesos que esperan a recuperar su cuota
+	libera_estrangulados_vencidos();
+
+	// Se carga el tick a la cuota del proceso en ejecucion; si la agota
+	// queda estrangulado hasta el siguiente periodo
+	if (p_proc_actual->estado == EJECUCION && p_proc_actual->cuota != 0 &&
+		cargar_cuota(p_proc_actual)) {
+		p_proc_actual->estado = ESTRANGULADO;
+		activar_int_SW();
+	}
+
+	// La clase del proceso en ejecucion decide si se le expulsa
+	// (en turno rotatorio, al agotar su rodaja)
+	if (p_proc_actual->estado == EJECUCION && CLASE(p_proc_actual)->tick(p_proc_actual)) {
+		p_proc_actual->estado = LISTO;
+		activar_int_SW();
+	}
+}
+
+/*
+ * Acumula en unos contadores una llamada ya terminada.
+ */
+static void contar_llamada(contadores_llamsis *c, unsigned long long ns,
+	unsigned long long ns_fuera, int bloqueo, int error){
+	c->ns_total += ns;
+	c->ns_sistema += ns - ns_fuera;
+	if (ns > c->ns_max)
+		c->ns_max = ns;
+	c->bloqueos += bloqueo;
+	c->errores += error;
+}
+
+/*
+ * Ejecuta el servicio nserv llevando sus estadisticas en el proceso y
+ * globalmente. La llamada se cuenta al entrar; una que no vuelve
+ * (terminar_proceso) no acumula tiempo. Se separa el tiempo total del
+ * que el proceso ha tenido el procesador (tiempo de sistema).
+ */
+static int ejecutar_servicio(int nserv){
+	BCPptr p = p_proc_actual;
+	unsigned int bloqueos = p->n_bloqueos;
+	unsigned long long t0, fuera0 = p->ns_fuera;
+	int res;
+
+	p->llamsis[nserv].llamadas++;
+	llamsis_global[nserv].llamadas++;
+	t0 = reloj_ns();
+
+	res=(tabla_servicios[nserv].fservicio)();
+
+	t0 = reloj_ns() - t0;
+	fuera0 = p->ns_fuera - fuera0;
+	contar_llamada(&p->llamsis[nserv], t0, fuera0, p->n_bloqueos != bloqueos, res < 0);
+	contar_llamada(&llamsis_global[nserv], t0, fuera0, p->n_bloqueos != bloqueos, res < 0);
+	return res;
+}
+
+/*
+ * Tratamiento de llamadas al sistema
+ */
+static void tratar_llamsis(){
+
+	// Variables
+	int nserv, res, n_int;
+
+	// Impedimos c. de contexto involuntarios por int sw
+	n_int = fijar_nivel_int(NIVEL_1);
+
+	estad_sistema.interrupciones[LLAM_SIS]++;
+	nserv=leer_registro(0);
+	if (nserv<NSERVICIOS)
+		res=ejecutar_servicio(nserv);
+	else
+		res=-1;		/* servicio no existente */
+	escribir_registro(0,res);
+
+	// Reestablecemos el nivel de ejecucion
+	fijar_nivel_int(n_int);
+
+	return;
+}
+
+/*
+ * Funcion auxiliar que duerme al proceso actual hasta el tick t_wake.
+ * Usada por dormir, dormir_ticks y dormir_hasta; int_reloj lo despierta.
+ */
+static void dormir_hasta_tick(unsigned int t_wake){
+
+	// Bloquear proceso
+	p_proc_actual->estado=DORMIDO;
+	p_proc_actual->t_wake=t_wake;
+
+	// Siguiente proceso
+	siguiente_rodaja();
+}
+
+/*
+ * Tratamiento de interrupciones software
+ */
+static void int_sw(){
+
+	estad_sistema.interrupciones[INT_SW]++;
+
+	// Comprobar que el proceso en ejecucion es el que hay que expulsar
+	if (p_proc_actual->estado == LISTO || p_proc_actual->estado == ESTRANGULADO) {
+		printk("[%f] \tTRATANDO INT. SW\n", (float) t_ticks/TICK);
+		siguiente_rodaja();
+	}
+
+	return;
+}
+
+/*
+ *
+ * Funcion auxiliar que rellena el BCP de la entrada proc con una imagen
+ * ya obtenida, sin insertarlo en ninguna lista.
+ * Usada por crear_tarea y crear_tareas.
+ *
+ */
+static BCP * preparar_tarea(int proc, void *imagen, void *pc_inicial, int imagen_id){
+	BCP *p_proc;
+	int i;
+
+	p_proc=BCP_ENTRADA(proc);
+	p_proc->info_mem=imagen;
+	p_proc->imagen_id=imagen_id;
+	p_proc->refs_imagen=NULL;
+	p_proc->funcion_hilo=NULL;
+	p_proc->arg_hilo=NULL;
+	p_proc->periodo=0;
+	p_proc->densidad=0;
+	p_proc->vruntime=0;
+	p_proc->nice=0;
+	p_proc->cuota=0;
+	p_proc->periodo_cuota=0;
+	p_proc->consumo_total=0;
+	p_proc->n_estrangulamientos=0;
+	p_proc->ticks_estrangulado=0;
+	p_proc->anillo=NULL;
+	p_proc->n_bloqueos=0;
+	p_proc->ns_fuera=0;
+	p_proc->ticks_usuario=0;
+	p_proc->ticks_sistema=0;
+	memset(p_proc->llamsis, 0, sizeof(p_proc->llamsis));
+	p_proc->argumentos[0]='\0';
+	p_proc->n_activaciones=0;
+	p_proc->n_fallos=0;
+	p_proc->pila=obtener_pila();
+	fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
+		pc_inicial,
+		&(p_proc->contexto_regs));
+	p_proc->generacion=(p_proc->generacion + 1) % MAX_GENERACION;
+	p_proc->id=p_proc->generacion*MAX_TABLA_PROCS + proc;
+	p_proc->estado=LISTO;
+
+	// Queda como hijo del proceso creador
+	p_proc->padre = (p_proc_actual != NULL) ? p_proc_actual->id : SIN_PADRE;
+	p_proc->estado_fin = 0;
+	p_proc->n_hijos = 0;
+	p_proc->lista_zombis = (lista_BCPs) {NULL, NULL};
+	p_proc->lista_esperando = (lista_BCPs) {NULL, NULL};
+	if (p_proc_actual != NULL)
+		p_proc_actual->n_hijos++;
+	else
+		id_init = p_proc->id;
+
+	// Hereda los descriptores de pipe del proceso creador salvo los
+	// marcados con PIPE_NO_HEREDAR
+	for (i = 0; i < NUM_PIPE_PROC; i++) {
+		p_proc->pipe_ids[i] = PIPE_DESC_NO_USADO;
+		if (p_proc_actual != NULL &&
+			p_proc_actual->pipe_ids[i] != PIPE_DESC_NO_USADO &&
+			(p_proc_actual->pipe_modos[i] & PIPE_NO_HEREDAR) == 0) {
+			p_proc->pipe_ids[i] = p_proc_actual->pipe_ids[i];
+			p_proc->pipe_modos[i] = p_proc_actual->pipe_modos[i];
+			ref_pipe_desc(p_proc->pipe_ids[i], p_proc->pipe_modos[i], 1);
+		}
+	}
+
+	return p_proc;
+}
+
+/*
+ *
+ * Funcion auxiliar que crea un proceso reservando sus recursos.
+ * Usada por llamada crear_proceso.
+ *
+ */
+static int crear_tarea(char *prog){
+	void * imagen, *pc_inicial;
+	int error=0;
+	int proc, n_int, imagen_id;
+	BCP *p_proc;
+
+	proc=buscar_BCP_libre();
+	if (proc==-1)
+		return -1;	/* no hay entrada libre */
+
+	/* crea la imagen de memoria leyendo ejecutable */
+	imagen=obtener_imagen(prog, &pc_inicial, &imagen_id);
+	if (imagen) {
+		/* A rellenar el BCP ... */
+		p_proc=preparar_tarea(proc, imagen, pc_inicial, imagen_id);
+
+		// Inhibir interrupciones
+		n_int = fijar_nivel_int(NIVEL_3);
+
+		// Modificar listas de BCPs
+		/* lo inserta en la cola de listos */
+		encolar_listo(p_proc);
+
+		// Deshinibir interrupciones
+		fijar_nivel_int(n_int);
+
+		error= p_proc->id;
+	}
+	else {
+		procs_libres[num_procs_libres++] = proc;
+		error= -1; /* fallo al crear imagen */
+	}
+
+	return error;
+}
+
+/*
+ *
+ * Funcion auxiliar que crea hasta n procesos del mismo programa
+ * buscando la imagen una sola vez y encolandolos todos en listos de
+ * una vez. Si ids no es nulo deja en el los ids de los creados, pero
+ * solo despues de encolarlos: un ids erroneo mata al llamante sin
+ * perder los BCPs ya preparados. Devuelve cuantos procesos ha creado.
+ * Usada por llamada crear_procesos.
+ *
+ */
+static int crear_tareas(char *prog, int n, int *ids){
+	void * imagen, *pc_inicial;
+	/* el kernel no es expulsivo: basta con un solo vector para todos */
+	static int ids_ker[MAX_TABLA_PROCS];
+	int creados, proc, n_int, imagen_id;
+	lista_BCPs nuevos={NULL, NULL};
+	BCP *p_proc;
+
+	/* no se pueden crear mas procesos que entradas tiene la tabla */
+	if (n > MAX_TABLA_PROCS)
+		n = MAX_TABLA_PROCS;
+
+	imagen=NULL;
+	imagen_id=IMAGEN_NO_CACHEADA;
+	for (creados=0; creados<n; creados++) {
+		proc=buscar_BCP_libre();
+		if (proc==-1)
+			break;	/* no hay entrada libre */
+
+		if (imagen == NULL || imagen_id == IMAGEN_NO_CACHEADA)
+			/* la HAL lleva la cuenta de las imagenes no cacheadas */
+			imagen=obtener_imagen(prog, &pc_inicial, &imagen_id);
+		else {
+			/* las demas instancias comparten la entrada de la cache */
+			estad_cache.aciertos++;
+			tabla_imagenes[imagen_id].n_refs++;
+		}
+		if (imagen == NULL) {
+			procs_libres[num_procs_libres++] = proc;
+			break;	/* fallo al crear imagen */
+		}
+
+		p_proc=preparar_tarea(proc, imagen, pc_inicial, imagen_id);
+		insertar_ultimo(&nuevos, p_proc);
+		ids_ker[creados] = p_proc->id;
+	}
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Modificar listas de BCPs
+	/* los pasa todos a la cola de listos de su clase */
+	while ((p_proc = nuevos.primero) != NULL) {
+		eliminar_primero(&nuevos);
+		encolar_listo(p_proc);
+	}
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	/* ya encolados: si ids no es valido solo muere el llamante */
+	if (ids != NULL && creados > 0) {
+		acc_param = 1;
+		memcpy(ids, ids_ker, creados*sizeof(int));
+		acc_param = 0;
+	}
+	return creados;
+}
+
+/*
+ *
+ * Rutinas que llevan a cabo las llamadas al sistema
+ *	sis_crear_proceso sis_escribir
+ *
+ */
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso.
+ * Devuelve el id del nuevo proceso.
+ */
+int sis_crear_proceso(){
+	char *prog;
+	int res;
+
+	printk("[%f] \tPROC %d: CREAR PROCESO\n", (float) t_ticks/TICK, p_proc_actual->id);
+	prog=(char *)leer_registro(1);
+	res=crear_tarea(prog);
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso_args. Como
+ * crear_proceso, pero deja al nuevo proceso una cadena de argumentos
+ * que este recoge con argumentos.
+ * Devuelve el id del proceso o -1 si no se pudo crear o la cadena no
+ * cabe en TAM_ARGUMENTOS.
+ */
+int sis_crear_proceso_args(){
+	char *prog, *args;
+	char copia[TAM_ARGUMENTOS];
+	int res, longi;
+
+	printk("[%f] \tPROC %d: CREAR PROCESO CON ARGUMENTOS\n", (float) t_ticks/TICK, p_proc_actual->id);
+	prog=(char *)leer_registro(1);
+	args=(char *)leer_registro(2);
+
+	acc_param = 1;
+	longi=(args != NULL) ? strnlen(args, TAM_ARGUMENTOS) : 0;
+	if (longi < TAM_ARGUMENTOS)
+		memcpy(copia, args, longi);
+	acc_param = 0;
+	if (longi >= TAM_ARGUMENTOS)
+		return -1;
+	copia[longi]='\0';
+
+	res=crear_tarea(prog);
+	if (res >= 0)
+		strcpy(BCP_ENTRADA(ENTRADA_ID(res))->argumentos, copia);
+	return res;
+}
+
+/*
+ * Tratamiento de llamada al sistema argumentos. Copia en el buffer del
+ * usuario (como mucho tam bytes, terminados en nulo) la cadena con la
+ * que se creo el proceso. Los hilos heredan la de su creador.
+ * Devuelve la longitud de la cadena completa.
+ */
+int sis_argumentos(){
+	char *buf;
+	unsigned int tam, longi;
+
+	buf=(char *)leer_registro(1);
+	tam=(unsigned int)leer_registro(2);
+
+	longi=strlen(p_proc_actual->argumentos);
+	if (tam == 0)
+		return longi;
+
+	acc_param = 1;
+	memcpy(buf, p_proc_actual->argumentos, (longi < tam) ? longi : tam-1);
+	buf[(longi < tam) ? longi : tam-1]='\0';
+	acc_param = 0;
+
+	return longi;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_hilo. Crea un proceso que
+ * comparte la imagen del actual, con su propia pila, y que arranca en
+ * la lanzadera de la biblioteca; esta lee funcion y argumento de la
+ * pagina de datos, sin entrar en el kernel. El hilo es hijo del
+ * creador, que lo espera con esperar_proceso.
+ * Devuelve el id del hilo.
+ */
+int sis_crear_hilo(){
+	void *lanzadera, *funcion, *arg;
+	int proc, n_int;
+	BCP *p_proc;
+
+	lanzadera=(void *)leer_registro(1);
+	funcion=(void *)leer_registro(2);
+	arg=(void *)leer_registro(3);
+
+	printk("[%f] \tPROC %d: CREAR HILO\n", (float) t_ticks/TICK, p_proc_actual->id);
+
+	proc=buscar_BCP_libre();
+	if (proc==-1)
+		return -1;	/* no hay entrada libre */
+
+	// El contador de hilos de la imagen se crea con el primer hilo
+	if (p_proc_actual->refs_imagen == NULL) {
+		p_proc_actual->refs_imagen = malloc(sizeof(int));
+		if (p_proc_actual->refs_imagen == NULL) {
+			procs_libres[num_procs_libres++] = proc;
+			return -1;
+		}
+		*p_proc_actual->refs_imagen = 1;
+	}
+	(*p_proc_actual->refs_imagen)++;
+
+	/* A rellenar el BCP ... */
+	p_proc=preparar_tarea(proc, p_proc_actual->info_mem, lanzadera,
+		p_proc_actual->imagen_id);
+	p_proc->refs_imagen=p_proc_actual->refs_imagen;
+	p_proc->funcion_hilo=funcion;
+	p_proc->arg_hilo=arg;
+	strcpy(p_proc->argumentos, p_proc_actual->argumentos);
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Modificar listas de BCPs
+	/* lo inserta en la cola de listos */
+	encolar_listo(p_proc);
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	return p_proc->id;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_procesos. Crea n procesos
+ * del programa indicado con una sola llamada y deja sus ids en el
+ * vector del usuario (si no es nulo). Llama a la funcion auxiliar
+ * crear_tareas.
+ * Devuelve el numero de procesos creados o -1 si no se pudo crear
+ * ninguno.
+ */
+int sis_crear_procesos(){
+	char *prog;
+	int n, *ids;
+	int res;
+
+	prog=(char *)leer_registro(1);
+	n=(int)leer_registro(2);
+	ids=(int *)leer_registro(3);
+
+	printk("[%f] \tPROC %d: CREAR %d PROCESOS\n", (float) t_ticks/TICK, p_proc_actual->id, n);
+	if (n <= 0)
+		return -1;
+
+	res=crear_tareas(prog, n, ids);
+	return (res > 0) ? res : -1;
+}
+
+/*
+ * Tratamiento de llamada al sistema escribir. Llama simplemente a la
+ * funcion de apoyo escribir_ker
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi;
+
+	texto=(char *)leer_registro(1);
+	longi=(unsigned int)leer_registro(2);
+
+	escribir_ker(texto, longi);
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Llama a la
+ * funcion auxiliar liberar_proceso
+ */
+int sis_terminar_proceso(){
+
+	printk("[%f] \tFIN PROCESO %d\n", (float) t_ticks/TICK, p_proc_actual->id);
+
+	p_proc_actual->estado_fin = 0;
+	liberar_proceso();
+
+    return 0; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de llamada al sistema salir. Como terminar_proceso pero
+ * dejando el estado de fin que recibira el padre en esperar_proceso.
+ */
+int sis_salir(){
+
+	printk("[%f] \tFIN PROCESO %d CON ESTADO %d\n", (float) t_ticks/TICK, p_proc_actual->id, (int)leer_registro(1));
+
+	p_proc_actual->estado_fin = (int)leer_registro(1);
+	liberar_proceso();
+
+    return 0; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de llamada al sistema esperar_proceso. Bloquea al proceso
+ * hasta que termine el hijo indicado (o cualquiera con CUALQUIER_HIJO),
+ * deja su estado de fin en *estado (si no es nulo) y libera su BCP.
+ * Devuelve el id del hijo esperado.
+ */
+int sis_esperar_proceso(){
+
+	// Variables
+	int id, id_hijo, *estado;
+	int n_int;
+	BCPptr p_hijo;
+
+	id = (int)leer_registro(1);
+	estado = (int *)leer_registro(2);
+
+	printk("[%f] \tPROC %d: ESPERAR PROCESO %d\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+
+	while (1) {
+
+		// Se busca un hijo terminado que valga
+		if (id == CUALQUIER_HIJO) {
+			if (p_proc_actual->n_hijos == 0)
+				return PROC_NO_CHILDREN;
+			p_hijo = p_proc_actual->lista_zombis.primero;
+		}
+		else {
+			p_hijo = buscar_BCP_id(id);
+			if (p_hijo == NULL || p_hijo->padre != p_proc_actual->id)
+				return PROC_NO_CHILD;
+			if (p_hijo->estado != ZOMBI)
+				p_hijo = NULL;
+		}
+
+		if (p_hijo != NULL)
+			break;
+
+		// Se bloquea hasta que termine algun hijo
+		p_proc_actual->estado = BLOQUEADO_HIJO;
+
+		// Siguiente proceso
+		siguiente_rodaja();
+	}
+
+	/* antes de sacarlo: si estado no es valido el zombi no se pierde */
+	if (estado != NULL) {
+		acc_param = 1;
+		*estado = p_hijo->estado_fin;
+		acc_param = 0;
+	}
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// Modificar listas de BCPs
+	eliminar_elem(&p_proc_actual->lista_zombis, p_hijo);
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	// Se libera la entrada del hijo
+	id_hijo = p_hijo->id;
+	p_proc_actual->n_hijos--;
+	p_hijo->estado = TERMINADO;
+	liberar_BCP(p_hijo);
+
+	return id_hijo;
+}
+
+/*
+ * Función que implementa la primera funcionalidad a desarrollar (obtener ID).
+ */
+int sis_obtener_id_pr() {
+	return p_proc_actual->id;
+}
+
+/*
+ * Función que implementa la segunda funcionalidad a desarrollar (dormir).
+ */
+int sis_dormir() {
+
+	// Variables
+	unsigned int segundos;
+
+	// Lectura de argumentos
+	segundos=(unsigned int)leer_registro(1);
+
+	dormir_hasta_tick(t_ticks + segundos*TICK);
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema dormir_ticks. Como dormir pero
+ * con el plazo en ticks.
+ */
+int sis_dormir_ticks() {
+
+	// Variables
+	unsigned int ticks;
+
+	// Lectura de argumentos
+	ticks=(unsigned int)leer_registro(1);
+
+	if (ticks > 0)
+		dormir_hasta_tick(t_ticks + ticks);
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema dormir_hasta. Duerme hasta el tick
+ * absoluto indicado (el reloj que devuelve tiempos_proceso), de modo
+ * que los retrasos de planificacion no se acumulan en los bucles
+ * periodicos. Si ya ha pasado vuelve sin bloquearse.
+ * Devuelve el tick en que se despierta.
+ */
+int sis_dormir_hasta() {
+
+	// Variables
+	unsigned int t_abs;
+
+	// Lectura de argumentos
+	t_abs=(unsigned int)leer_registro(1);
+
+	if (t_abs > t_ticks)
+		dormir_hasta_tick(t_abs);
+
+	return t_ticks;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_temporizador_periodico. El
+ * proceso pasa a activarse cada periodo ticks con un plazo de plazo
+ * ticks (0: igual al periodo) para un trabajo de hasta coste ticks, y
+ * se planifica por EDF antes que los procesos de turno rotatorio. Se
+ * admite si la suma de coste/plazo de los periodicos no supera 1. Con
+ * periodo 0 el proceso vuelve al turno rotatorio.
+ */
+int sis_crear_temporizador_periodico() {
+
+	// Variables
+	unsigned int periodo, plazo, coste;
+	int densidad, n_int;
+	BCPptr p = p_proc_actual;
+
+	// Lectura de argumentos
+	periodo=(unsigned int)leer_registro(1);
+	plazo=(unsigned int)leer_registro(2);
+	coste=(unsigned int)leer_registro(3);
+
+	printk("[%f] \tPROC %d: TEMPORIZADOR PERIODICO %d/%d/%d\n", (float) t_ticks/TICK, p->id, periodo, plazo, coste);
+
+	// Vuelta al turno rotatorio
+	if (periodo == 0) {
+		if (p->periodo == 0)
+			return TR_NOT_PERIODIC;
+
+		n_int = fijar_nivel_int(NIVEL_3);
+		desencolar_listo(p);
+		utilizacion_tr -= p->densidad;
+		p->periodo = 0;
+		p->densidad = 0;
+		encolar_listo(p);
+		fijar_nivel_int(n_int);
+		return 0;
+	}
+
+	if (plazo == 0)
+		plazo = periodo;
+	if (coste == 0 || coste > plazo || plazo > periodo)
+		return TR_BAD_PARAM;
+
+	// Control de admision (redondeando la densidad hacia arriba)
+	densidad = (coste*MAX_UTILIZACION + plazo - 1)/plazo;
+	if (utilizacion_tr - p->densidad + densidad > MAX_UTILIZACION)
+		return TR_ADMISSION;
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	// El primer trabajo se activa ya
+	desencolar_listo(p);
+	utilizacion_tr += densidad - p->densidad;
+	p->periodo = periodo;
+	p->plazo = plazo;
+	p->densidad = densidad;
+	p->t_activacion = t_ticks;
+	p->t_plazo = t_ticks + plazo;
+	p->n_activaciones = 0;
+	p->n_fallos = 0;
+	encolar_listo(p);
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	// Si otro periodico tiene un plazo anterior, se le cede el procesador
+	if (lista_tr.primero != p) {
+		p->estado = LISTO;
+		cesion = 1;
+		siguiente_rodaja();
+	}
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema esperar_periodo. Da por terminado
+ * el trabajo actual, contando un fallo si se ha pasado del plazo (y
+ * uno por cada activacion que ya no se puede cumplir), y duerme hasta
+ * la siguiente activacion.
+ */
+int sis_esperar_periodo() {
+
+	// Variables
+	BCPptr p = p_proc_actual;
+
+	if (p->periodo == 0)
+		return TR_NOT_PERIODIC;
+
+	p->n_activaciones++;
+	if (t_ticks > p->t_plazo) {
+		printk("[%f] \tPROCESO %d FALLA SU PLAZO %d\n", (float) t_ticks/TICK, p->id, p->t_plazo);
+		p->n_fallos++;
+	}
+
+	// Las activaciones cuyo plazo ya ha pasado se pierden
+	p->t_activacion += p->periodo;
+	while (p->t_activacion + p->plazo <= t_ticks) {
+		p->n_activaciones++;
+		p->n_fallos++;
+		p->t_activacion += p->periodo;
+	}
+	p->t_plazo = p->t_activacion + p->plazo;
+
+	if (p->t_activacion > t_ticks)
+		dormir_hasta_tick(p->t_activacion);
+	else {
+		// Ya activado: se recoloca segun el nuevo plazo
+		p->estado = LISTO;
+		cesion = 1;
+		siguiente_rodaja();
+	}
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema estadisticas_tr. Copia los
+ * contadores del proceso periodico y la utilizacion reservada.
+ */
+int sis_estadisticas_tr() {
+	struct estad_tr *est;
+
+	est=(struct estad_tr *)leer_registro(1);
+
+	if (est == NULL)
+		return -1;
+
+	acc_param = 1;
+	est->activaciones = p_proc_actual->n_activaciones;
+	est->fallos = p_proc_actual->n_fallos;
+	est->utilizacion = utilizacion_tr;
+	acc_param = 0;
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema ceder_procesador. El proceso pasa
+ * detras de los demas listos de su clase sin esperar a agotar su rodaja.
+ */
+int sis_ceder_procesador() {
+
+	// Variables
+	int n_int;
+
+	printk("[%f] \tPROCESO %d CEDE EL PROCESADOR\n", (float) t_ticks/TICK, p_proc_actual->id);
+
+	p_proc_actual->estado=LISTO;
+	n_int = fijar_nivel_int(NIVEL_3);
+	CLASE(p_proc_actual)->ceder(p_proc_actual);
+	cesion = 1;
+	fijar_nivel_int(n_int);
+
+	// Siguiente proceso
+	siguiente_rodaja();
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_nice. Fija la prioridad del
+ * proceso no periodico; solo tiene efecto con la clase CFS,
+ * donde determina su peso.
+ */
+int sis_fijar_nice() {
+	int nice;
+
+	nice=(int)leer_registro(1);
+
+	if (nice < NICE_MIN || nice > NICE_MAX)
+		return NICE_BAD_PARAM;
+
+	p_proc_actual->nice = nice;
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema fijar_cuota. Limita el proceso id a
+ * ticks de procesador en cada periodo de periodo ticks; al agotarlos
+ * queda estrangulado hasta que empieza el siguiente. Con ticks y
+ * periodo a 0 se quita el limite.
+ */
+int sis_fijar_cuota() {
+
+	// Variables
+	int id, n_int;
+	unsigned int ticks, periodo;
+	BCPptr p;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+	ticks=(unsigned int)leer_registro(2);
+	periodo=(unsigned int)leer_registro(3);
+
+	// La cuota tiene que dejar sin usar parte del periodo
+	if (periodo == 0 ? ticks != 0 : (ticks == 0 || ticks >= periodo))
+		return CUOTA_BAD_PARAM;
+
+	p = buscar_BCP_id(id);
+	if (p == NULL || p->estado == ZOMBI)
+		return CUOTA_NO_PROC;
+
+	printk("[%f] \tPROCESO %d LIMITADO A %u DE CADA %u TICKS\n", (float) t_ticks/TICK, id, ticks, periodo);
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	p->cuota = ticks;
+	p->periodo_cuota = periodo;
+	p->consumo_cuota = 0;
+	p->t_fin_cuota = t_ticks + periodo;
+	p->consumo_total = 0;
+
+	// Sin limite ya no tiene que esperar al siguiente periodo
+	if (ticks == 0 && p->estado == ESTRANGULADO)
+		libera_estrangulado(p);
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema estadisticas_cuota. Devuelve la
+ * cuota del proceso id y cuanto lo ha estrangulado.
+ */
+int sis_estadisticas_cuota() {
+
+	// Variables
+	int id;
+	struct estad_cuota *est;
+	BCPptr p;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+	est=(struct estad_cuota *)leer_registro(2);
+
+	if (est == NULL)
+		return CUOTA_BAD_PARAM;
+
+	p = buscar_BCP_id(id);
+	if (p == NULL)
+		return CUOTA_NO_PROC;
+
+	acc_param = 1;
+	est->cuota = p->cuota;
+	est->periodo = p->periodo_cuota;
+	est->consumo_total = p->consumo_total;
+	est->estrangulamientos = p->n_estrangulamientos;
+	est->ticks_estrangulado = p->ticks_estrangulado;
+	acc_param = 0;
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema crear_anillo. Registra el anillo de
+ * llamadas del proceso (NULL para quitarlo) y lo deja vacio.
+ */
+int sis_crear_anillo() {
+
+	// Variables
+	struct anillo_llamsis *anillo;
+
+	// Lectura de argumentos
+	anillo=(struct anillo_llamsis *)leer_registro(1);
+
+	if (anillo != NULL) {
+		acc_param = 1;
+		anillo->cab_sub = anillo->cola_sub = 0;
+		anillo->cab_com = anillo->cola_com = 0;
+		acc_param = 0;
+	}
+	p_proc_actual->anillo = anillo;
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema entrar_anillo. Ejecuta en orden las
+ * peticiones encoladas en el anillo del proceso, pasando sus argumentos
+ * en los registros como una llamada normal, y deja cada resultado en
+ * la parte de resultados. Para si esta se llena. Las llamadas que se
+ * bloquean lo hacen dentro del bucle. Devuelve cuantas ha ejecutado.
+ */
+int sis_entrar_anillo() {
+
+	// Variables
+	struct anillo_llamsis *anillo;
+	struct peticion_llamsis pet;
+	int i, n, res;
+
+	anillo = p_proc_actual->anillo;
+	if (anillo == NULL)
+		return ANILLO_NO_CREADO;
+
+	for (n = 0; ; n++) {
+		acc_param = 1;
+		if (anillo->cab_sub == anillo->cola_sub ||
+			anillo->cola_com - anillo->cab_com >= TAM_ANILLO_LLAMSIS) {
+			acc_param = 0;
+			break;
+		}
+		pet = anillo->sub[anillo->cab_sub % TAM_ANILLO_LLAMSIS];
+		anillo->cab_sub++;
+		acc_param = 0;
+
+		// Las llamadas del propio anillo no se pueden anidar
+		if (pet.servicio < 0 || pet.servicio >= NSERVICIOS ||
+			pet.servicio == CREAR_ANILLO || pet.servicio == ENTRAR_ANILLO)
+			res = -1;	/* servicio no existente */
+		else {
+			for (i = 0; i < ARGS_ANILLO_LLAMSIS; i++)
+				escribir_registro(i+1, pet.args[i]);
+			res = ejecutar_servicio(pet.servicio);
+		}
+
+		acc_param = 1;
+		anillo->com[anillo->cola_com % TAM_ANILLO_LLAMSIS].res = res;
+		anillo->com[anillo->cola_com % TAM_ANILLO_LLAMSIS].dato = pet.dato;
+		anillo->cola_com++;
+		acc_param = 0;
+	}
+
+	return n;
+}
+
+/*
+ * Función auxiliar de foto_procesos que busca el mutex, pipe o cola en
+ * cuya lista esta bloqueado el proceso. Deja su nombre (el puntero del
+ * objeto, NULL si no tiene) y, si es un mutex, su dueño.
+ * Devuelve el descriptor del objeto o SIN_ESPERA.
+ */
+static int buscar_espera(BCP *p, char **nombre, int *dueno){
+	int i;
+
+	*nombre = NULL;
+	*dueno = -1;
+	switch (p->estado) {
+		case BLOQUEADO_MTX:
+			for (i=0; i<NUM_MUT; i++)
+				if (en_lista(&tabla_mutex[i].lista_bloqueados, p)) {
+					*nombre = tabla_mutex[i].nombre;
+					*dueno = tabla_mutex[i].p_id;
+					return i;
+				}
+			break;
+		case BLOQUEADO_PIPE_LEC:
+		case BLOQUEADO_PIPE_ESC:
+			for (i=0; i<NUM_PIPES; i++)
+				if (en_lista(&tabla_pipes[i].lista_lectores, p) ||
+					en_lista(&tabla_pipes[i].lista_escritores, p)) {
+					*nombre = tabla_pipes[i].nombre;
+					return i;
+				}
+			break;
+		case BLOQUEADO_COLA_REC:
+		case BLOQUEADO_COLA_ENV:
+			for (i=0; i<NUM_COLAS; i++)
+				if (en_lista(&tabla_colas[i].lista_receptores, p) ||
+					en_lista(&tabla_colas[i].lista_emisores, p)) {
+					*nombre = tabla_colas[i].nombre;
+					return i;
+				}
+			break;
+	}
+	return SIN_ESPERA;
+}
+
+/*
+ * Tratamiento de llamada al sistema foto_procesos. Rellena foto con el
+ * recuento de procesos por estado y copia en procs los datos de hasta n
+ * procesos. La foto se toma en un buffer del kernel con las
+ * interrupciones inhibidas para que sea coherente, y se copia al
+ * usuario despues, ya con ellas habilitadas.
+ * Devuelve el numero de procesos de la tabla (puede ser mayor que n).
+ */
+int sis_foto_procesos() {
+
+	/* el kernel no es expulsivo: basta con un solo buffer para todos */
+	static struct info_proc fotos[MAX_TABLA_PROCS];
+
+	// Variables
+	struct foto_sistema *foto, f;
+	struct info_proc *procs, *q;
+	unsigned int n;
+	int i, j, n_int, copiados=0, dueno;
+	char *nombre;
+	BCP *p;
+
+	// Lectura de argumentos
+	foto=(struct foto_sistema *)leer_registro(1);
+	procs=(struct info_proc *)leer_registro(2);
+	n=(unsigned int)leer_registro(3);
+
+	memset(&f, 0, sizeof(f));
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+
+	f.ticks = t_ticks;
+	for (i=0; i<num_entradas_procs; i++) {
+		p = BCP_ENTRADA(i);
+		if (p->estado == NO_USADA)
+			continue;
+
+		f.n_procs++;
+		switch (p->estado) {
+			case LISTO: f.n_listos++; break;
+			case DORMIDO: f.n_dormidos++; break;
+			case ESTRANGULADO: f.n_estrangulados++; break;
+			case ZOMBI: f.n_zombis++; break;
+			case EJECUCION: break;
+			default: f.n_bloqueados++; break;
+		}
+
+		if (procs == NULL || copiados >= n)
+			continue;
+
+		q = &fotos[copiados++];
+		q->id = p->id;
+		q->padre = p->padre;
+		q->estado = p->estado;
+		q->prog[0] = '\0';
+		if (p->imagen_id != IMAGEN_NO_CACHEADA)
+			strncat(q->prog, tabla_imagenes[p->imagen_id].nombre, TAM_NOMBRE_FOTO-1);
+		q->espera = buscar_espera(p, &nombre, &dueno);
+		q->nombre_espera[0] = '\0';
+		if (nombre != NULL)
+			strncat(q->nombre_espera, nombre, TAM_NOMBRE_FOTO-1);
+		q->dueno_espera = dueno;
+		q->t_wake = p->t_wake;
+		q->ticks_usuario = p->ticks_usuario;
+		q->ticks_sistema = p->ticks_sistema;
+		q->nice = p->nice;
+		for (j=0; j<NUM_MUT_PROC; j++)
+			q->mutex_ids[j] = p->mutex_ids[j];
+	}
+
+	// Deshinibir interrupciones
+	fijar_nivel_int(n_int);
+
+	acc_param = 1;
+	if (foto != NULL)
+		*foto = f;
+	if (copiados > 0)
+		memcpy(procs, fotos, copiados*sizeof(struct info_proc));
+	acc_param = 0;
+
+	return f.n_procs;
+}
+
+/*
+ * Tratamiento de llamada al sistema estadisticas_sistema. Copia los
+ * contadores globales, con las medias de carga pasadas a milesimas.
+ */
+int sis_estadisticas_sistema() {
+
+	// Variables
+	struct estad_sistema *est, e;
+	int i, n_int;
+
+	// Lectura de argumentos
+	est=(struct estad_sistema *)leer_registro(1);
+
+	if (est == NULL)
+		return -1;
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+	e = estad_sistema;
+	e.ticks = t_ticks;
+	e.ejecutables = n_ejecutables;
+	for (i=0; i<3; i++)
+		e.carga[i] = (carga_fija[i]*1000 + UNO_CARGA/2) >> BITS_CARGA;
+	fijar_nivel_int(n_int);
+
+	acc_param = 1;
+	*est = e;
+	acc_param = 0;
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema iniciar_perfil. Empieza a guardar
+ * el PC de usuario del proceso id en cada tick que le toca, descartando
+ * las muestras de un perfil anterior.
+ */
+int sis_iniciar_perfil() {
+
+	// Variables
+	int id, n_int;
+	BCPptr p;
+	perfil_proceso *perfil;
+	void *marco;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+
+	p = buscar_BCP_id(id);
+	if (p == NULL || p->estado == ZOMBI)
+		return PERFIL_NO_PROC;
+
+	perfil = p->perfil;
+	if (perfil == NULL && (perfil = malloc(sizeof(perfil_proceso))) == NULL)
+		return PERFIL_SIN_MEMORIA;
+
+	// La primera llamada a backtrace carga la biblioteca con la que
+	// recorre la pila: se hace aqui y no en la interrupcion de reloj
+	backtrace(&marco, 1);
+
+	printk("[%f] \tPERFIL DEL PROCESO %d INICIADO\n", (float) t_ticks/TICK, id);
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+	perfil->info = (struct info_perfil) {.activo=1};
+	p->perfil = perfil;
+	fijar_nivel_int(n_int);
+
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema parar_perfil. Deja de tomar
+ * muestras del proceso id; las tomadas se pueden seguir leyendo.
+ */
+int sis_parar_perfil() {
+	int id;
+	BCPptr p;
+
+	id=(int)leer_registro(1);
+
+	p = buscar_BCP_id(id);
+	if (p == NULL)
+		return PERFIL_NO_PROC;
+	if (p->perfil == NULL)
+		return PERFIL_NO_INICIADO;
+
+	p->perfil->info.activo = 0;
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema leer_perfil. Copia el estado del
+ * perfil del proceso id (aunque ya sea zombi) y hasta max de sus
+ * muestras.
+ * Devuelve el numero de muestras copiadas.
+ */
+int sis_leer_perfil() {
+
+	// Variables
+	int id, n_int;
+	unsigned int max, n;
+	struct info_perfil *info, i;
+	void **muestras;
+	BCPptr p;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+	info=(struct info_perfil *)leer_registro(2);
+	muestras=(void **)leer_registro(3);
+	max=(unsigned int)leer_registro(4);
+
+	p = buscar_BCP_id(id);
+	if (p == NULL)
+		return PERFIL_NO_PROC;
+	if (p->perfil == NULL)
+		return PERFIL_NO_INICIADO;
+
+	// Inhibir interrupciones
+	n_int = fijar_nivel_int(NIVEL_3);
+	i = p->perfil->info;
+	i.terminado = (p->estado == ZOMBI);
+	fijar_nivel_int(n_int);
+
+	// Las muestras ya guardadas no cambian aunque se sigan tomando
+	n = (i.muestras < max) ? i.muestras : max;
+	acc_param = 1;
+	if (info != NULL)
+		*info = i;
+	if (n > 0)
+		memcpy(muestras, p->perfil->pc, n*sizeof(void *));
+	acc_param = 0;
+
+	return n;
+}
+
+/*
+ * Tratamiento de llamada al sistema simbolizar. Escribe en nombre
+ * "programa:funcion" para una direccion de una imagen cargada (con la
+ * funcion "?" si no se encuentra en su tabla de simbolos).
+ * Devuelve el desplazamiento de la direccion dentro de la funcion.
+ */
+int sis_simbolizar() {
+
+	// Variables
+	char *dir, *nombre;
+	const char *prog;
+	unsigned int tam, longi;
+	unsigned long desp, inicio;
+	char simbolo[TAM_SIMBOLO], texto[TAM_SIMBOLO];
+	Dl_info info;
+
+	// Lectura de argumentos
+	dir=(char *)leer_registro(1);
+	nombre=(char *)leer_registro(2);
+	tam=(unsigned int)leer_registro(3);
+
+	if (!dladdr(dir, &info) || info.dli_fname == NULL)
+		return PERFIL_SIN_SIMBOLO;
+
+	// Sin .symtab queda lo que ve dladdr (solo los simbolos exportados)
+	desp = dir - (char *)info.dli_fbase;
+	if (buscar_simbolo(info.dli_fname, desp, simbolo, &inicio) < 0) {
+		strcpy(simbolo, "?");
+		inicio = desp;
+		if (info.dli_sname != NULL) {
+			strncpy(simbolo, info.dli_sname, TAM_SIMBOLO-1);
+			simbolo[TAM_SIMBOLO-1] = '\0';
+			inicio = (char *)info.dli_saddr - (char *)info.dli_fbase;
+		}
+	}
+
+	prog = strrchr(info.dli_fname, '/');
+	prog = (prog != NULL) ? prog+1 : info.dli_fname;
+	strncpy(texto, prog, TAM_SIMBOLO-1);
+	texto[TAM_SIMBOLO-1] = '\0';
+	strncat(texto, ":", TAM_SIMBOLO-1-strlen(texto));
+	strncat(texto, simbolo, TAM_SIMBOLO-1-strlen(texto));
+
+	longi = strlen(texto);
+	if (tam > 0) {
+		acc_param = 1;
+		memcpy(nombre, texto, (longi < tam) ? longi : tam-1);
+		nombre[(longi < tam) ? longi : tam-1] = '\0';
+		acc_param = 0;
+	}
+
+	return desp - inicio;
+}
+
+/*
+ * Tratamiento de llamada al sistema estadisticas_secciones. Copia en
+ * tabla hasta n puntos del kernel que han cerrado alguna seccion
+ * critica, con su numero, tiempo total y maximo e histograma.
+ * Devuelve el numero de puntos que hay.
+ */
+int sis_estadisticas_secciones() {
+
+	// Variables
+	struct estad_seccion *tabla, e;
+	unsigned int n, i;
+	int n_int, total;
+	seccion_crit *s;
+
+	// Lectura de argumentos
+	tabla=(struct estad_seccion *)leer_registro(1);
+	n=(unsigned int)leer_registro(2);
+
+	// Los puntos solo se añaden al principio de la lista
+	n_int = fijar_nivel_int(NIVEL_3);
+	total = n_secciones;
+	s = lista_secciones;
+	fijar_nivel_int(n_int);
+
+	for (i = 0; i < n && s != NULL; i++, s = s->siguiente) {
+		n_int = fijar_nivel_int(NIVEL_3);
+		strncpy(e.funcion, s->funcion, TAM_NOMBRE_SECCION-1);
+		e.funcion[TAM_NOMBRE_SECCION-1] = '\0';
+		e.linea = s->linea;
+		e.nivel = s->nivel;
+		e.veces = s->veces;
+		e.ns_total = s->ns_total;
+		e.ns_max = s->ns_max;
+		memcpy(e.histograma, s->histograma, sizeof(e.histograma));
+		fijar_nivel_int(n_int);
+
+		acc_param = 1;
+		tabla[i] = e;
+		acc_param = 0;
+	}
+
+	return total;
+}
+
+/*
+ * Tratamiento de llamada al sistema estadisticas_llamsis. Copia en tabla
+ * hasta n entradas con el uso de cada servicio por el proceso id (o por
+ * todos con LLAMSIS_GLOBAL). Devuelve el numero de servicios.
+ */
+int sis_estadisticas_llamsis() {
+
+	// Variables
+	int id, i;
+	unsigned int n;
+	struct estad_llamsis *tabla;
+	contadores_llamsis *c;
+	BCPptr p;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+	tabla=(struct estad_llamsis *)leer_registro(2);
+	n=(unsigned int)leer_registro(3);
+
+	if (id == LLAMSIS_GLOBAL)
+		c = llamsis_global;
+	else if ((p = buscar_BCP_id(id)) != NULL)
+		c = p->llamsis;
+	else
+		return LLAMSIS_NO_PROC;
+
+	acc_param = 1;
+	for (i = 0; i < NSERVICIOS && i < n; i++) {
+		strncpy(tabla[i].nombre, tabla_servicios[i].nombre, TAM_NOMBRE_LLAMSIS-1);
+		tabla[i].nombre[TAM_NOMBRE_LLAMSIS-1] = '\0';
+		tabla[i].c = c[i];
+	}
+	acc_param = 0;
+
+	return NSERVICIOS;
+}
+
+/*
+ * Tratamiento de llamada al sistema datos_kernel. Deja en *dir la
+ * direccion de la pagina de datos del kernel, de solo lectura.
+ */
+int sis_datos_kernel() {
+
+	// Variables
+	struct datos_kernel **dir;
+
+	// Lectura de argumentos
+	dir=(struct datos_kernel **)leer_registro(1);
+
+	if (dir == NULL)
+		return -1;
+
+	acc_param = 1;
+	*dir = datos_usuario;
+	acc_param = 0;
+
+	return 0;
+}
+
+/*
+ * Función que implementa la tercera funcionalidad a desarrollar 
+ * (contabilidad de uso del procesador).
+ */
+int sis_tiempos_proceso() {
+
+	// Variables
+	struct tiempos_ejec* tiempos;
+	int n_int;
+
+	// Lectura de argumentos
+	tiempos=(struct tiempos_ejec *)leer_registro(1);
+
+	// Gestionando argumentos erroneos
+	if (tiempos != NULL && acc_param == 0) {
+
+		// Inhibir interrupciones
+		n_int = fijar_nivel_int(NIVEL_3);
+
+		// Concurrencia mientras se accede a parametros
+		acc_param = 1;
+		tiempos->usuario=t_usr;
+		tiempos->sistema=t_sys;
+		acc_param = 0;
+
+		// Deshinibir interrupciones
+		fijar_nivel_int(n_int);
+	}
+
+	// Returning elapsed ticks
+	return t_ticks;
+}
+
+/*
+ * Función que devuelve en el parámetro los ns pasados desde el arranque,
+ * con la resolucion del reloj monotono de la maquina anfitriona.
+ */
+int sis_obtener_tiempo_ns() {
+
+	// Variables
+	unsigned long long *t;
+
+	// Lectura de argumentos
+	t=(unsigned long long *)leer_registro(1);
+
+	if (t == NULL)
+		return -1;
+
+	acc_param = 1;
+	*t = reloj_ns() - t_arranque_ns;
+	acc_param = 0;
+
+	return 0;
+}
+
+/*
+ * Función que devuelve en el parámetro la hora del reloj CMOS (ms desde
+ * el 1 de enero de 1970).
+ */
+int sis_obtener_hora() {
+
+	// Variables
+	unsigned long long *ms;
+
+	// Lectura de argumentos
+	ms=(unsigned long long *)leer_registro(1);
+
+	if (ms == NULL)
+		return -1;
+
+	acc_param = 1;
+	*ms = leer_reloj_CMOS();
+	acc_param = 0;
+
+	return 0;
+}
+
+/* Llamadas relacionadas con los mutexes */
+/*
+ * Función que elimina un determinado mutex cuyo id se pasa 
+ * como parámetro.
+ */
+void eliminar_mutex(int id) {
+
+	// Marcando el hueco como libre
+	tabla_mutex[id].estado = MTX_NO_USADO;
+
+	// Despertando a uno de los porcesos esperando a liberar un hueco
+	despierta_primero(&lista_bloqueados_mtx);
+}
+
+/*
+ * Función que implementa la operación de crear un mutex de 
+ * la cuarta funcionalidad a desarrollar (mutex).
+ */
+int sis_crear_mutex(){
+
+	// Variables
+	mutexptr m;
+	char* nombre;
+	int tipo, ret, id;
+
+	// Lectura de argumentos
+	nombre=(char*)leer_registro(1);
+	tipo=(int)leer_registro(2);
+
+	// Comprobar que el proceso puede tener mutex asignados
+	if (num_mutex_desc() >= NUM_MUT_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return MUTEX_MAX_DESC;
+	}
+	
+	// Comprobar longitud del nombre y que no exista
+	ret = mutex_valid_name(nombre);
+	if (ret < 0) {
+		if (ret == MUTEX_NAME_LONG) {
+			printk("[%f] \tNOMBRBE DEL MUTEX DEMASIADO LARGO\n", (float) t_ticks/TICK);
+			return MUTEX_NAME_LONG;
+		} else if (ret == MUTEX_NAME_EXIST) {
+			printk("[%f] \tYA EXISTE UN MUTEX LLAMADO %s\n", (float) t_ticks/TICK, nombre);
+			return MUTEX_NAME_EXIST;
+		}
+	}
+
+	// Comprobar que queden huecos libres
+	ret = get_avail_mutex();
+	while (ret < 0) {
+
+		// Bloquar el proceso
+		p_proc_actual->estado=BLOQUEADO;
+
+		printk("[%f] \tPROCESO %d ESPERA A ELIMINAR UN MUTEX\n", (float) t_ticks/TICK, p_proc_actual->id);
+
+		// Siguiente proceso
+		siguiente_rodaja();
+		
+		// Comprobar de nuevo que no exista otro con ese nombre despues de la espera
+		ret = mutex_valid_name(nombre);
+		if (ret < 0) {
+			printk("[%f] \tAL DESPERTAR %d EXISTE UN MUTEX LLAMADO %s\n", (float) t_ticks/TICK, p_proc_actual->id, nombre);
+			return MUTEX_NAME_EXIST;
+		}
+
+		// Comprobar que siguen habiendo libres
+		ret = get_avail_mutex();
+	}
+
+	// Inicializacion del mutex
+	id = get_avail_mutex();
+	m = &tabla_mutex[id];
+	m->estado = MTX_DESBLOQUEADO;
+	m->tipo = tipo;
+	m->nombre = strdup(nombre);
+	m->lista_bloqueados= (lista_BCPs) {NULL, NULL};
+	if (tipo == RECURSIVO) m->n_anidamiento = 0;
+
+	printk("[%f] \tPROCESO %d CREA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, m->nombre);
+
+	// Abriendo el mutex
+	escribir_registro(1, (long) nombre); // Paso de parametros
+	sis_abrir_mutex();
+
+	// Devolver descriptor
+	return id;
+}
+
+/*
+ * Función que implementa la operación de abrir un mutex de 
+ * la cuarta funcionalidad a desarrollar (mutex).
+ */
+int sis_abrir_mutex(){
+
+	// Variables
+	char* nombre;
+	int ret;
+
+	// Lectura de argumentos
+	nombre=(char*)leer_registro(1);
+
+	// Comprobar que el proceso puede tener mutex asignados
+	if (num_mutex_desc() >= NUM_MUT_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return MUTEX_MAX_DESC;
+	}
+
+	// Buscar el mutex
+	ret = mutex_search_name(nombre);
+	if (ret == MUTEX_NO_EXIST) {
+		// Error
+		printk("[%f] \tNO EXISTE EL MUTEX %s\n", (float) t_ticks/TICK, nombre);
+		return MUTEX_NO_EXIST;
+	}
+
+	// Asociando el descriptor al proceso
+	add_mutex_desc(ret);
+	
+	printk("[%f] \tPROCESO %d ABRE EL MUTEX %d (%s)\n", (float) t_ticks/TICK, sis_obtener_id_pr(), ret, tabla_mutex[ret].nombre);
+
+	return ret;
+}
+
+/*
+ * Función que implementa la operación de bloquear un mutex de 
+ * la cuarta funcionalidad a desarrollar (mutex).
+ */
+int sis_lock(){
+	
+	// Variables
+	int id;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+
+	// Caso de que el mutex no se haya creado
+	if (tabla_mutex[id].estado == MTX_NO_USADO) {
+		printk("[%f] \tMUTEX %d NO CREADO\n", (float) t_ticks/TICK, id);
+		return MUTEX_NO_EXIST;
+	}
+
+	// Caso de que el proceso no tenga abierto el mutex
+	if (mutex_is_opened(id) < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE EL MUTEX %d ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+		return MUTEX_CLOSED;
+	}
+
+	// Caso de que el dueño del mutex lo quiera volver a tomar
+	if (tabla_mutex[id].p_id == sis_obtener_id_pr() && tabla_mutex[id].estado == MTX_BLOQUEADO) {
+		if (tabla_mutex[id].tipo == RECURSIVO) { 	// Si es recursivo -> se incrementa el nivel de anidamiento
+			tabla_mutex[id].n_anidamiento++;
+			printk("[%f] \tPROCESO %d VUELVE A TOMAR EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+			printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
+		} else { 									// Si no es recursivo -> se devuelve un error
+			printk("[%f] \tPROCESO %d INTENTA TOMAR EL MUTEX NO RECURSIVO %d (%s)\n", 
+				(float) t_ticks/TICK, sis_obtener_id_pr(), id, tabla_mutex[id].nombre);
+			return MUTEX_LOCK_FAIL;
+		}
+	// Caso de que quien lo quiere tomar no sea el dueño
+	} else {
+		while (tabla_mutex[id].estado == MTX_BLOQUEADO){
+			// Bloquear el proceso
+			p_proc_actual->estado=BLOQUEADO_MTX;
+
+			printk("[%f] \tPROCESO %d ESPERA A LIBERAR MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+
+			// Siguiente proceso
+			siguiente_rodaja();
+		}
+
+		// Se toma el mutex
+		tabla_mutex[id].estado = MTX_BLOQUEADO;
+		tabla_mutex[id].p_id = sis_obtener_id_pr();
+
+		printk("[%f] \tPROCESO %d TOMA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+		if (tabla_mutex[id].tipo == RECURSIVO) {
+			tabla_mutex[id].n_anidamiento++;
+			printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Función que implementa la operación de desbloquear un mutex de 
+ * la cuarta funcionalidad a desarrollar (mutex).
+ */
+int sis_unlock(){
+	
+	// Variables
+	int id;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+
+	// Caso de que el mutex no se haya creado
+	if (tabla_mutex[id].estado == MTX_NO_USADO) {
+		printk("[%f] \tMUTEX %d NO CREADO\n", (float) t_ticks/TICK, id);
+		return MUTEX_NO_EXIST;
+	}
+
+	// Comprobar que es dueño del mutex
+	if (sis_obtener_id_pr() != tabla_mutex[id].p_id) {
+		printk("[%f] \tPROCESO %d INTENTA LIBERAR EL MUTEX %d (%s) PERO NO LO POSEE (LO POSEE %d)\n", 
+			(float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre, tabla_mutex[id].p_id);
+		return MUTEX_UNLOCK_FAIL;
+	}
+
+	printk("[%f] \tPROCESO %d LIBERA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+
+	// Caso de que sea recursivo
+	if (tabla_mutex[id].tipo == RECURSIVO && tabla_mutex[id].n_anidamiento > 0) {
+		tabla_mutex[id].n_anidamiento--;
+		printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
+	}
+
+	// Sólo se libera realmente si el nivel de anidamiento es 0 o no es recursivo
+	if (tabla_mutex[id].tipo == NO_RECURSIVO || 
+		(tabla_mutex[id].tipo == RECURSIVO && tabla_mutex[id].n_anidamiento == 0)){
+		// Se libera el mutex
+		tabla_mutex[id].estado = MTX_DESBLOQUEADO;
+
+		// Despertando proceso bloqueado a la espera de liberar el mutex si los hay
+		despierta_primero(&tabla_mutex[id].lista_bloqueados);
+	}
+	
+	return 0;
+}
+
+/*
+ * Función que implementa la operación de cerrar un mutex de 
+ * la cuarta funcionalidad a desarrollar (mutex).
+ */
+int sis_cerrar_mutex(){
+	
+	// Variables
+	int id;
+
+	// Lectura de argumentos
+	id=(int)leer_registro(1);
+
+	// Comprobando que el proceso tiene el mutex abierto
+	if (del_mutex_desc(id) == MUTEX_CLOSED) {
+		printk("[%f] \tPROCESO %d NO TIENE EL MUTEX %d (%s) ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+		return MUTEX_CLOSED;
+	}
+
+	printk("[%f] \tPROCESO %d CIERRA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+
+	// Si el dueño es quien lo cierra, se desbloquea
+	if (tabla_mutex[id].p_id == sis_obtener_id_pr() &&
+		tabla_mutex[id].estado == MTX_BLOQUEADO) {
+		// Reestablecemos el numero de anidamientos si es recursivo
+		if (tabla_mutex[id].tipo == RECURSIVO)
+			tabla_mutex[id].n_anidamiento = 1; // Lo ponemos a 1 para que unlock haga el decremento y el print
+		sis_unlock();
+	}
+
+	// Si no hay nadie que tenga abierto el mutex, se elimnina
+	if (open_mutex_count(id) == 0) {
+		printk("\t\tSE ELIMINA EL MUTEX %d (%s), NINGUN PROCESO LO USA\n", id, tabla_mutex[id].nombre);
+		eliminar_mutex(id);
+	}
+
+	return 0;
+}
+
+int sis_leer_caracter() {
+
+	// Variables
+	char ret;
+	int n_int, eval;
+
+	// Inhibir interrupciones de terminal para evaluar condicion
+	n_int = fijar_nivel_int(NIVEL_2);
+
+	eval = start_char - read_chars; 
+	
+	// Deshinibir interrupciones de terminal
+	fijar_nivel_int(n_int);
+
+	// Caso de  que no queden caracteres en el buffer
+	while (eval >= 0) {
+		// Bloquar el proceso
+		p_proc_actual->estado=BLOQUEADO_TERM;
+
+		printk("[%f] \tPROCESO %d ESPERA A LEER UN CARACTER\n", (float) t_ticks/TICK, p_proc_actual->id);
+
+		// Siguiente proceso
+		siguiente_rodaja();
+
+		// Inhibir interrupciones de terminal para evaluar condicion
+		n_int = fijar_nivel_int(NIVEL_2);
+
+		eval = start_char - read_chars; 
+		
+		// Deshinibir interrupciones de terminal
+		fijar_nivel_int(n_int);
+	}
+
+	// Leemos el caracter
+	ret = char_buff[start_char % TAM_BUF_TERM];
+	start_char++;
+
+	return ret;
+}
+
+/* Llamadas relacionadas con los pipes */
+/*
+ * Función que implementa la operación de crear un pipe. Si el
+ * nombre es NULL el pipe es anonimo y solo lo comparten los 
+ * procesos que hereden el descriptor devuelto. El modo puede hacer
+ * del descriptor un extremo de solo lectura o de solo escritura.
+ */
+int sis_crear_pipe(){
+
+	// Variables
+	pipeptr p;
+	char* nombre_usr;
+	char nombre[MAX_NOM_PIPE];
+	unsigned int tam;
+	int modo, id;
+
+	// Lectura de argumentos
+	nombre_usr=(char*)leer_registro(1);
+	tam=(unsigned int)leer_registro(2);
+	modo=(int)leer_registro(3);
+
+	// Comprobar el tamaño del buffer
+	if (tam == 0 || tam > TAM_MAX_PIPE) {
+		printk("[%f] \tTAMAÑO DE PIPE %d NO VALIDO\n", (float) t_ticks/TICK, tam);
+		return PIPE_BAD_SIZE;
+	}
+
+	// Un descriptor no puede ser a la vez solo de lectura y solo de escritura
+	if (!PIPE_LEE(modo) && !PIPE_ESCRIBE(modo))
+		return PIPE_BAD_MODE;
+
+	// Comprobar que el proceso puede tener pipes asignados
+	if (num_pipe_desc() >= NUM_PIPE_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE PIPE\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return PIPE_MAX_DESC;
+	}
+
+	// Comprobar longitud del nombre y que no exista
+	if (nombre_usr != NULL) {
+		if (leer_nombre(nombre, nombre_usr, MAX_NOM_PIPE) < 0) {
+			printk("[%f] \tNOMBRE DEL PIPE DEMASIADO LARGO\n", (float) t_ticks/TICK);
+			return PIPE_NAME_LONG;
+		}
+		if (pipe_search_name(nombre) >= 0) {
+			printk("[%f] \tYA EXISTE UN PIPE LLAMADO %s\n", (float) t_ticks/TICK, nombre);
+			return PIPE_NAME_EXIST;
+		}
+	}
+
+	// Comprobar que queden huecos libres
+	id = get_avail_pipe();
+	if (id < 0) {
+		printk("[%f] \tNO QUEDAN PIPES LIBRES\n", (float) t_ticks/TICK);
+		return PIPE_TABLE_FULL;
+	}
+
+	// Inicializacion del pipe
+	p = &tabla_pipes[id];
+	if ((p->buffer = malloc(tam)) == NULL) {
+		printk("[%f] \tNO HAY MEMORIA PARA UN PIPE DE %d BYTES\n", (float) t_ticks/TICK, tam);
+		return PIPE_NO_MEMORY;
+	}
+	p->estado = PIPE_USADO;
+	p->nombre = (nombre_usr != NULL) ? strdup(nombre) : NULL;
+	p->tam = tam;
+	p->inicio = 0;
+	p->n_bytes = 0;
+	p->n_abiertos = 0;
+	p->n_lectores = 0;
+	p->n_escritores = 0;
+	p->lista_lectores = (lista_BCPs) {NULL, NULL};
+	p->lista_escritores = (lista_BCPs) {NULL, NULL};
+
+	printk("[%f] \tPROCESO %d CREA EL PIPE %d (%s) DE %d BYTES\n", (float) t_ticks/TICK, 
+		p_proc_actual->id, id, (nombre_usr != NULL) ? nombre : "anonimo", tam);
+
+	// Devolver descriptor
+	return add_pipe_desc(id, modo);
+}
+
+/*
+ * Función que implementa la operación de abrir un pipe con nombre.
+ */
+int sis_abrir_pipe(){
+
+	// Variables
+	char* nombre_usr;
+	char nombre[MAX_NOM_PIPE] = "";
+	int modo, id, desc;
+
+	// Lectura de argumentos
+	nombre_usr=(char*)leer_registro(1);
+	modo=(int)leer_registro(2);
+
+	// Un descriptor no puede ser a la vez solo de lectura y solo de escritura
+	if (!PIPE_LEE(modo) && !PIPE_ESCRIBE(modo))
+		return PIPE_BAD_MODE;
+
+	// Comprobar que el proceso puede tener pipes asignados
+	if (num_pipe_desc() >= NUM_PIPE_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE PIPE\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return PIPE_MAX_DESC;
+	}
+
+	// Buscar el pipe
+	id = PIPE_NO_EXIST;
+	if (nombre_usr != NULL && leer_nombre(nombre, nombre_usr, MAX_NOM_PIPE) >= 0)
+		id = pipe_search_name(nombre);
+	if (id == PIPE_NO_EXIST) {
+		printk("[%f] \tNO EXISTE EL PIPE %s\n", (float) t_ticks/TICK, nombre);
+		return PIPE_NO_EXIST;
+	}
 
-	if (!viene_de_modo_usuario() && acc_param == 0)
-		panico("excepcion de memoria cuando estaba dentro del kernel");
+	// Asociando el descriptor al proceso
+	desc = add_pipe_desc(id, modo);
 
-	printk("[%f] \tEXCEPCION DE MEMORIA EN PROC %d\n", (float) t_ticks/TICK, p_proc_actual->id);
-	liberar_proceso();
+	printk("[%f] \tPROCESO %d ABRE EL PIPE %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, nombre);
 
-    return; /* no deber�a llegar aqui */
+	return desc;
 }
 
 /*
- * Tratamiento de interrupciones de terminal
+ * Función que implementa la operación de leer de un pipe. Devuelve
+ * el numero de bytes leidos, 0 si el pipe esta vacio y no queda
+ * ningun otro descriptor que pueda escribir en el (fin de fichero).
  */
-static void int_terminal(){
+int sis_leer_pipe(){
 
 	// Variables
-	int n_int;
-	char car;
+	pipeptr p;
+	unsigned int desc, tam, n, trozo;
+	char *buf;
+	int id, modo;
 
-	// Impedimos c. de contexto involuntarios por int sw
-	n_int = fijar_nivel_int(NIVEL_1);
+	// Lectura de argumentos
+	desc=(unsigned int)leer_registro(1);
+	buf=(char*)leer_registro(2);
+	tam=(unsigned int)leer_registro(3);
+
+	// Comprobando que el proceso tiene el pipe abierto
+	id = pipe_desc_id(desc);
+	if (id < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE EL DESCRIPTOR DE PIPE %d ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, desc);
+		return PIPE_CLOSED;
+	}
+	p = &tabla_pipes[id];
+	modo = p_proc_actual->pipe_modos[desc];
 
-	car = leer_puerto(DIR_TERMINAL);
+	if (!PIPE_LEE(modo))
+		return PIPE_BAD_MODE;
 
-	// Almacenamos el caracter si hay hueco en el buffer
-	if (read_chars - start_char < TAM_BUF_TERM) {
-		char_buff[read_chars % TAM_BUF_TERM] = car;
-		read_chars++;
+	if (tam == 0)
+		return 0;
+
+	// Caso de que no queden datos en el buffer
+	while (p->n_bytes == 0) {
+		// Sin otro extremo de escritura no podra llegar ningun dato
+		if (p->n_escritores - PIPE_ESCRIBE(modo) == 0)
+			return 0;
+
+		if (modo & PIPE_NO_BLOQUEANTE)
+			return PIPE_WOULD_BLOCK;
+
+		// Bloquar el proceso
+		p_proc_actual->estado=BLOQUEADO_PIPE_LEC;
+
+		printk("[%f] \tPROCESO %d ESPERA A LEER DEL PIPE %d\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+
+		// Siguiente proceso
+		siguiente_rodaja();
 	}
 
-	printk("[%f] \tTRATANDO INT. DE TERMINAL %c CARACTERES LEIDOS %d\n", 
-		(float) t_ticks/TICK, car, read_chars - start_char);
+	// Copiamos los datos, como mucho en dos trozos del buffer circular
+	n = (tam < p->n_bytes) ? tam : p->n_bytes;
+	trozo = (n < p->tam - p->inicio) ? n : p->tam - p->inicio;
 
-	// Reestablecemos el nivel de ejecucion
-	fijar_nivel_int(n_int);
+	acc_param = 1;
+	memcpy(buf, &p->buffer[p->inicio], trozo);
+	memcpy(buf + trozo, p->buffer, n - trozo);
+	acc_param = 0;
 
-	// Despertando proceso bloqueado a la espera de leer un carcter si los hay
-	despierta_primero(&lista_bloqueados_term);
+	p->inicio = (p->inicio + n) % p->tam;
+	p->n_bytes -= n;
 
-    return;
+	// Despertando procesos bloqueados a la espera de hueco si los hay
+	despierta_todos(&p->lista_escritores);
+
+	return n;
 }
 
 /*
- * Tratamiento de interrupciones de reloj
+ * Función que implementa la operación de escribir en un pipe. En modo
+ * bloqueante no termina hasta haber escrito todos los bytes.
+ * Devuelve el numero de bytes escritos.
  */
-static void int_reloj(){
+int sis_escribir_pipe(){
 
 	// Variables
-	BCPptr p = lista_dormidos.primero, p_next;
-	unsigned int n_int;
-
-	// Incrementamos el numero de ticks actuales del kernel
-	t_ticks++;
+	pipeptr p;
+	unsigned int desc, tam, n, trozo, fin, total=0;
+	char *buf;
+	int id, modo;
 
-	// Gestion de tiempos si hay procesos activos
-	if (lista_listos.primero != NULL) {
-		if (viene_de_modo_usuario())
-			t_usr++;
-		else
-			t_sys++;
-		// Si el proceso no actua como el nulo, esta consumiendo su rodaja
-		t_proc++;
+	// Lectura de argumentos
+	desc=(unsigned int)leer_registro(1);
+	buf=(char*)leer_registro(2);
+	tam=(unsigned int)leer_registro(3);
+
+	// Comprobando que el proceso tiene el pipe abierto
+	id = pipe_desc_id(desc);
+	if (id < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE EL DESCRIPTOR DE PIPE %d ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, desc);
+		return PIPE_CLOSED;
 	}
+	p = &tabla_pipes[id];
+	modo = p_proc_actual->pipe_modos[desc];
 
-	printk("[%f] \tTRATANDO INT. DE RELOJ (TIEMPO RESTANTE DE RODAJA: %d)\n", 
-	 	(float) t_ticks/TICK, TICKS_POR_RODAJA - t_proc);
-
-	// Tratando procesos esperando un plazo
-	while (p != NULL) {
+	if (!PIPE_ESCRIBE(modo))
+		return PIPE_BAD_MODE;
 
-		// Reservamos el valor del siguiente
-		p_next = p->siguiente;
+	while (total < tam) {
 
-		// Si se cumple el plazo, desbloqueamos el proceso
-		if (p->t_wake <= t_ticks) {
-			printk("[%f] \tPROCESO %d LISTO\n", (float) t_ticks/TICK, p->id);
+		// Caso de que el buffer este lleno
+		if (p->n_bytes == p->tam) {
+			// Sin otro extremo de lectura nunca quedara hueco
+			if (p->n_lectores - PIPE_LEE(modo) == 0)
+				return (total > 0) ? total : PIPE_BROKEN;
 
-			// Cambiamos su estado
-			p->estado = LISTO;
+			if (modo & PIPE_NO_BLOQUEANTE)
+				return (total > 0) ? total : PIPE_WOULD_BLOCK;
 
-			// Inhibir interrupciones
-			n_int = fijar_nivel_int(NIVEL_3);
+			// Bloquar el proceso
+			p_proc_actual->estado=BLOQUEADO_PIPE_ESC;
 
-			// Modificar listas de BCPs
-			eliminar_elem(&lista_dormidos,p);
-			insertar_ultimo(&lista_listos,p);
+			printk("[%f] \tPROCESO %d ESPERA A ESCRIBIR EN EL PIPE %d\n", (float) t_ticks/TICK, p_proc_actual->id, id);
 
-			// Deshinibir interrupciones
-			fijar_nivel_int(n_int);
+			// Siguiente proceso
+			siguiente_rodaja();
+			continue;
 		}
 
-		// Avanzamos el puntero
-		p = p_next;
-	}
+		// Copiamos los datos, como mucho en dos trozos del buffer circular
+		fin = (p->inicio + p->n_bytes) % p->tam;
+		n = (tam - total < p->tam - p->n_bytes) ? tam - total : p->tam - p->n_bytes;
+		trozo = (n < p->tam - fin) ? n : p->tam - fin;
 
-	// Pasado el suficiente tiempo, el proceso agota su rodaja
-	if (t_proc >= TICKS_POR_RODAJA) {
-		p_proc_actual->estado = LISTO;
-		activar_int_SW();
+		acc_param = 1;
+		memcpy(&p->buffer[fin], buf + total, trozo);
+		memcpy(p->buffer, buf + total + trozo, n - trozo);
+		acc_param = 0;
+
+		p->n_bytes += n;
+		total += n;
+
+		// Despertando procesos bloqueados a la espera de datos si los hay
+		despierta_todos(&p->lista_lectores);
 	}
+
+	return total;
 }
 
 /*
- * Tratamiento de llamadas al sistema
+ * Función que implementa la operación de cerrar un descriptor de pipe.
+ * El pipe se elimina al cerrar el ultimo descriptor que lo referencia.
  */
-static void tratar_llamsis(){
+int sis_cerrar_pipe(){
 
 	// Variables
-	int nserv, res, n_int;
+	pipeptr p;
+	unsigned int desc;
+	int id;
 
-	// Impedimos c. de contexto involuntarios por int sw
-	n_int = fijar_nivel_int(NIVEL_1);
+	// Lectura de argumentos
+	desc=(unsigned int)leer_registro(1);
 
-	nserv=leer_registro(0);
-	if (nserv<NSERVICIOS)
-		res=(tabla_servicios[nserv].fservicio)();
-	else
-		res=-1;		/* servicio no existente */
-	escribir_registro(0,res);
+	// Comprobando que el proceso tiene el pipe abierto
+	id = pipe_desc_id(desc);
+	if (id < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE EL DESCRIPTOR DE PIPE %d ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, desc);
+		return PIPE_CLOSED;
+	}
+	p = &tabla_pipes[id];
 
-	// Reestablecemos el nivel de ejecucion
-	fijar_nivel_int(n_int);
+	printk("[%f] \tPROCESO %d CIERRA EL PIPE %d\n", (float) t_ticks/TICK, p_proc_actual->id, id);
 
-	return;
+	p_proc_actual->pipe_ids[desc] = PIPE_DESC_NO_USADO;
+	ref_pipe_desc(id, p_proc_actual->pipe_modos[desc], -1);
+
+	// Si no hay nadie que tenga abierto el pipe, se elimina
+	if (p->n_abiertos == 0) {
+		printk("\t\tSE ELIMINA EL PIPE %d, NINGUN PROCESO LO USA\n", id);
+		free(p->nombre);
+		free(p->buffer);
+		p->estado = PIPE_NO_USADO;
+	} else {
+		// Los procesos bloqueados deben reevaluar si siguen teniendo con quien comunicarse
+		despierta_todos(&p->lista_lectores);
+		despierta_todos(&p->lista_escritores);
+	}
+
+	return 0;
 }
 
+/* Llamadas relacionadas con las colas de mensajes */
 /*
- * Tratamiento de interrupciones software
+ * Función que elimina una determinada cola cuyo id se pasa 
+ * como parámetro, liberando los mensajes que aun contenga.
  */
-static void int_sw(){
+void eliminar_cola(int id) {
 
-	// Comprobar que el proceso en ejecucion es el que hay que expulsar
-	if (p_proc_actual->estado == LISTO) {
-		printk("[%f] \tTRATANDO INT. SW\n", (float) t_ticks/TICK);
-		siguiente_rodaja();
+	// Variables
+	colaptr c = &tabla_colas[id];
+	celdaptr m;
+
+	while ((m = c->primero) != NULL) {
+		c->primero = m->siguiente;
+		if (m->buf_id != BUF_MSJ_NINGUNO)
+			eliminar_buffer(m->buf_id);
+		liberar_celda(m);
 	}
 
-	return;
+	free(c->nombre);
+	c->estado = COLA_NO_USADA;
 }
 
 /*
- *
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+ * Función que implementa la operación de crear una cola de mensajes.
  */
-static int crear_tarea(char *prog){
-	void * imagen, *pc_inicial;
-	int error=0;
-	int proc, n_int;
-	BCP *p_proc;
-
-	proc=buscar_BCP_libre();
-	if (proc==-1)
-		return -1;	/* no hay entrada libre */
+int sis_crear_cola(){
 
-	/* A rellenar el BCP ... */
-	p_proc=&(tabla_procs[proc]);
+	// Variables
+	colaptr c;
+	char* nombre_usr;
+	char nombre[MAX_NOM_COLA];
+	unsigned int max_mensajes;
+	int id;
 
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen=crear_imagen(prog, &pc_inicial);
-	if (imagen) {
-		p_proc->info_mem=imagen;
-		p_proc->pila=crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-			pc_inicial,
-			&(p_proc->contexto_regs));
-		p_proc->id=proc;
-		p_proc->estado=LISTO;
+	// Lectura de argumentos
+	nombre_usr=(char*)leer_registro(1);
+	max_mensajes=(unsigned int)leer_registro(2);
 
-		// Inhibir interrupciones
-		n_int = fijar_nivel_int(NIVEL_3);
+	// Comprobar la capacidad pedida
+	if (max_mensajes == 0 || max_mensajes > MAX_MSJ_COLA) {
+		printk("[%f] \tCAPACIDAD DE COLA %d NO VALIDA\n", (float) t_ticks/TICK, max_mensajes);
+		return COLA_BAD_SIZE;
+	}
 
-		// Modificar listas de BCPs
-		/* lo inserta al final de cola de listos */
-		insertar_ultimo(&lista_listos, p_proc);
+	// Comprobar que el proceso puede tener colas asignadas
+	if (num_cola_desc() >= NUM_COLA_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE COLA\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return COLA_MAX_DESC;
+	}
 
-		// Deshinibir interrupciones
-		fijar_nivel_int(n_int);
+	// Comprobar longitud del nombre y que no exista
+	if (leer_nombre(nombre, nombre_usr, MAX_NOM_COLA) < 0) {
+		printk("[%f] \tNOMBRE DE LA COLA DEMASIADO LARGO\n", (float) t_ticks/TICK);
+		return COLA_NAME_LONG;
+	}
+	if (cola_search_name(nombre) >= 0) {
+		printk("[%f] \tYA EXISTE UNA COLA LLAMADA %s\n", (float) t_ticks/TICK, nombre);
+		return COLA_NAME_EXIST;
+	}
 
-		error= 0;
+	// Comprobar que queden huecos libres
+	id = get_avail_cola();
+	if (id < 0) {
+		printk("[%f] \tNO QUEDAN COLAS LIBRES\n", (float) t_ticks/TICK);
+		return COLA_TABLE_FULL;
 	}
-	else
-		error= -1; /* fallo al crear imagen */
 
-	return error;
-}
+	// Inicializacion de la cola
+	c = &tabla_colas[id];
+	c->estado = COLA_USADA;
+	c->nombre = strdup(nombre);
+	c->max_mensajes = max_mensajes;
+	c->n_mensajes = 0;
+	c->primero = NULL;
+	c->lista_receptores = (lista_BCPs) {NULL, NULL};
+	c->lista_emisores = (lista_BCPs) {NULL, NULL};
 
-/*
- *
- * Rutinas que llevan a cabo las llamadas al sistema
- *	sis_crear_proceso sis_escribir
- *
- */
+	printk("[%f] \tPROCESO %d CREA LA COLA %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, c->nombre);
 
-/*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
- */
-int sis_crear_proceso(){
-	char *prog;
-	int res;
+	// Asociando el descriptor al proceso
+	add_cola_desc(id);
 
-	printk("[%f] \tPROC %d: CREAR PROCESO\n", (float) t_ticks/TICK, p_proc_actual->id);
-	prog=(char *)leer_registro(1);
-	res=crear_tarea(prog);
-	return res;
+	return id;
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
+ * Función que implementa la operación de abrir una cola de mensajes.
  */
-int sis_escribir()
-{
-	char *texto;
-	unsigned int longi;
+int sis_abrir_cola(){
 
-	texto=(char *)leer_registro(1);
-	longi=(unsigned int)leer_registro(2);
+	// Variables
+	char* nombre_usr;
+	char nombre[MAX_NOM_COLA] = "";
+	int id;
 
-	escribir_ker(texto, longi);
-	return 0;
-}
+	// Lectura de argumentos
+	nombre_usr=(char*)leer_registro(1);
 
-/*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
- */
-int sis_terminar_proceso(){
+	// Comprobar que el proceso puede tener colas asignadas
+	if (num_cola_desc() >= NUM_COLA_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE COLA\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return COLA_MAX_DESC;
+	}
 
-	printk("[%f] \tFIN PROCESO %d\n", (float) t_ticks/TICK, p_proc_actual->id);
+	// Buscar la cola
+	id = COLA_NO_EXIST;
+	if (leer_nombre(nombre, nombre_usr, MAX_NOM_COLA) >= 0)
+		id = cola_search_name(nombre);
+	if (id == COLA_NO_EXIST) {
+		printk("[%f] \tNO EXISTE LA COLA %s\n", (float) t_ticks/TICK, nombre);
+		return COLA_NO_EXIST;
+	}
 
-	liberar_proceso();
+	// Asociando el descriptor al proceso
+	add_cola_desc(id);
 
-    return 0; /* no deber�a llegar aqui */
-}
+	printk("[%f] \tPROCESO %d ABRE LA COLA %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_colas[id].nombre);
 
-/*
- * Función que implementa la primera funcionalidad a desarrollar (obtener ID).
- */
-int sis_obtener_id_pr() {
-	return p_proc_actual->id;
+	return id;
 }
 
 /*
- * Función que implementa la segunda funcionalidad a desarrollar (dormir).
+ * Función que implementa la operación de enviar un mensaje. Los
+ * mensajes de hasta TAM_MSJ_PEQ bytes se copian en una celda del slab;
+ * los mayores deben estar en un buffer obtenido con reservar_mensaje,
+ * cuya propiedad se cede al receptor sin copiar los datos.
  */
-int sis_dormir() {
+int sis_enviar(){
 
 	// Variables
-	unsigned int segundos;
+	colaptr c;
+	celdaptr m, *pm;
+	struct mensaje msj;
+	char datos[TAM_MSJ_PEQ];
+	int id, timeout, buf_id = BUF_MSJ_NINGUNO;
+	unsigned int limite = 0;
 
 	// Lectura de argumentos
-	segundos=(unsigned int)leer_registro(1);
+	id=(int)leer_registro(1);
+	timeout=(int)leer_registro(3);
 
-	// Bloquear proceso
-	p_proc_actual->estado=DORMIDO;
-	p_proc_actual->t_wake=t_ticks + segundos*TICK;
+	// Copia de la descripcion del mensaje; no se vuelve a leer
+	acc_param = 1;
+	msj = *(struct mensaje *)leer_registro(2);
+	acc_param = 0;
 
-	// Siguiente proceso
-	siguiente_rodaja();
+	// Comprobando que el proceso tiene la cola abierta
+	if (id < 0 || id >= NUM_COLAS || cola_is_opened(id) < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE LA COLA %d ABIERTA\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+		return COLA_CLOSED;
+	}
+	c = &tabla_colas[id];
+
+	// Comprobando el mensaje
+	if (msj.tam > TAM_MAX_MSJ)
+		return COLA_BAD_SIZE;
+	if (msj.tam > TAM_MSJ_PEQ) {
+		buf_id = buffer_search_dir(msj.datos);
+		if (buf_id < 0 || tabla_buffers[buf_id].dueno != p_proc_actual->id ||
+			tabla_buffers[buf_id].tam < msj.tam) {
+			printk("[%f] \tPROCESO %d NO POSEE EL BUFFER DEL MENSAJE\n", (float) t_ticks/TICK, p_proc_actual->id);
+			return COLA_BAD_BUFFER;
+		}
+	} else {
+		// Se copia antes de reservar la celda, que no se libera si falla
+		acc_param = 1;
+		memcpy(datos, msj.datos, msj.tam);
+		acc_param = 0;
+	}
+
+	if (timeout > 0)
+		limite = t_ticks + timeout;
+
+	// Caso de que la cola este llena
+	while (c->n_mensajes >= c->max_mensajes) {
+		if (timeout == 0 || (limite != 0 && limite <= t_ticks)) {
+			p_proc_actual->t_limite = 0;
+			return COLA_TIMEOUT;
+		}
+
+		// Bloquar el proceso
+		p_proc_actual->estado=BLOQUEADO_COLA_ENV;
+		p_proc_actual->t_limite=limite;
+
+		printk("[%f] \tPROCESO %d ESPERA A ENVIAR A LA COLA %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, c->nombre);
+
+		// Siguiente proceso
+		siguiente_rodaja();
+	}
+	p_proc_actual->t_limite = 0;
+
+	// Preparando la celda del mensaje
+	if ((m = reservar_celda()) == NULL) {
+		printk("[%f] \tNO QUEDAN CELDAS DE MENSAJE LIBRES\n", (float) t_ticks/TICK);
+		return COLA_SLAB_FULL;
+	}
+	m->prioridad = msj.prioridad;
+	m->tam = msj.tam;
+	m->buf_id = buf_id;
+	if (buf_id == BUF_MSJ_NINGUNO)
+		memcpy(m->datos, datos, msj.tam);
+	else
+		tabla_buffers[buf_id].dueno = -1;
+
+	// Insertando detras de los mensajes con igual o mayor prioridad
+	for (pm = &c->primero; *pm != NULL && (*pm)->prioridad >= m->prioridad; pm = &(*pm)->siguiente);
+	m->siguiente = *pm;
+	*pm = m;
+	c->n_mensajes++;
+
+	// Despertando proceso bloqueado a la espera de un mensaje si los hay
+	despierta_primero(&c->lista_receptores);
 
 	return 0;
 }
 
 /*
- * Función que implementa la tercera funcionalidad a desarrollar 
- * (contabilidad de uso del procesador).
+ * Función que implementa la operación de recibir un mensaje. Los
+ * mensajes pequeños se copian en msj->datos, cuya capacidad indica
+ * msj->tam; en los grandes msj->datos pasa a apuntar al buffer cedido,
+ * que el receptor debe devolver con liberar_mensaje.
+ * Devuelve el tamaño del mensaje.
  */
-int sis_tiempos_proceso() {
+int sis_recibir(){
 
 	// Variables
-	struct tiempos_ejec* tiempos;
-	int n_int;
+	colaptr c;
+	celdaptr m;
+	struct mensaje *msj;
+	int id, timeout, tam;
+	unsigned int limite = 0;
 
 	// Lectura de argumentos
-	tiempos=(struct tiempos_ejec *)leer_registro(1);
+	id=(int)leer_registro(1);
+	msj=(struct mensaje *)leer_registro(2);
+	timeout=(int)leer_registro(3);
 
-	// Gestionando argumentos erroneos
-	if (tiempos != NULL && acc_param == 0) {
+	// Comprobando que el proceso tiene la cola abierta
+	if (id < 0 || id >= NUM_COLAS || cola_is_opened(id) < 0) {
+		printk("[%f] \tPROCESO %d NO TIENE LA COLA %d ABIERTA\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+		return COLA_CLOSED;
+	}
+	c = &tabla_colas[id];
 
-		// Inhibir interrupciones
-		n_int = fijar_nivel_int(NIVEL_3);
+	if (timeout > 0)
+		limite = t_ticks + timeout;
 
-		// Concurrencia mientras se accede a parametros
-		acc_param = 1;
-		tiempos->usuario=t_usr;
-		tiempos->sistema=t_sys;
-		acc_param = 0;
+	// Caso de que la cola este vacia
+	while (c->n_mensajes == 0) {
+		if (timeout == 0 || (limite != 0 && limite <= t_ticks)) {
+			p_proc_actual->t_limite = 0;
+			return COLA_TIMEOUT;
+		}
 
-		// Deshinibir interrupciones
-		fijar_nivel_int(n_int);
-	}
+		// Bloquar el proceso
+		p_proc_actual->estado=BLOQUEADO_COLA_REC;
+		p_proc_actual->t_limite=limite;
 
-	// Returning elapsed ticks
-	return t_ticks;
-}
+		printk("[%f] \tPROCESO %d ESPERA A RECIBIR DE LA COLA %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, c->nombre);
 
-/* Llamadas relacionadas con los mutexes */
-/*
- * Función que elimina un determinado mutex cuyo id se pasa 
- * como parámetro.
- */
-void eliminar_mutex(int id) {
+		// Siguiente proceso
+		siguiente_rodaja();
+	}
+	p_proc_actual->t_limite = 0;
+
+	// Un mensaje pequeño debe caber en el buffer del receptor
+	m = c->primero;
+	acc_param = 1;
+	tam = msj->tam;
+	acc_param = 0;
+	if (m->buf_id == BUF_MSJ_NINGUNO && m->tam > tam)
+		return COLA_BAD_SIZE;
+
+	// Se entrega antes de extraerlo: si el receptor falla, sigue en la cola
+	acc_param = 1;
+	if (m->buf_id == BUF_MSJ_NINGUNO)
+		memcpy(msj->datos, m->datos, m->tam);
+	else
+		msj->datos = tabla_buffers[m->buf_id].datos;
+	msj->tam = m->tam;
+	msj->prioridad = m->prioridad;
+	acc_param = 0;
 
-	// Marcando el hueco como libre
-	tabla_mutex[id].estado = MTX_NO_USADO;
+	// Extrayendo el mensaje de mayor prioridad
+	if (m->buf_id != BUF_MSJ_NINGUNO)
+		tabla_buffers[m->buf_id].dueno = p_proc_actual->id;
+	c->primero = m->siguiente;
+	c->n_mensajes--;
+	tam = m->tam;
 
-	// Despertando a uno de los porcesos esperando a liberar un hueco
-	despierta_primero(&lista_bloqueados_mtx);
+	liberar_celda(m);
+
+	// Despertando proceso bloqueado a la espera de hueco si los hay
+	despierta_primero(&c->lista_emisores);
+
+	return tam;
 }
 
 /*
- * Función que implementa la operación de crear un mutex de 
- * la cuarta funcionalidad a desarrollar (mutex).
+ * Función que implementa la operación de cerrar una cola de mensajes.
  */
-int sis_crear_mutex(){
+int sis_cerrar_cola(){
 
 	// Variables
-	mutexptr m;
-	char* nombre;
-	int tipo, ret, id;
+	int id;
 
 	// Lectura de argumentos
-	nombre=(char*)leer_registro(1);
-	tipo=(int)leer_registro(2);
+	id=(int)leer_registro(1);
 
-	// Comprobar que el proceso puede tener mutex asignados
-	if (num_mutex_desc() >= NUM_MUT_PROC) {
-		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES\n", (float) t_ticks/TICK, p_proc_actual->id);
-		return MUTEX_MAX_DESC;
+	// Comprobando que el proceso tiene la cola abierta
+	if (del_cola_desc(id) == COLA_CLOSED) {
+		printk("[%f] \tPROCESO %d NO TIENE LA COLA %d ABIERTA\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+		return COLA_CLOSED;
 	}
-	
-	// Comprobar longitud del nombre y que no exista
-	ret = mutex_valid_name(nombre);
-	if (ret < 0) {
-		if (ret == MUTEX_NAME_LONG) {
-			printk("[%f] \tNOMBRBE DEL MUTEX DEMASIADO LARGO\n", (float) t_ticks/TICK);
-			return MUTEX_NAME_LONG;
-		} else if (ret == MUTEX_NAME_EXIST) {
-			printk("[%f] \tYA EXISTE UN MUTEX LLAMADO %s\n", (float) t_ticks/TICK, nombre);
-			return MUTEX_NAME_EXIST;
-		}
+
+	printk("[%f] \tPROCESO %d CIERRA LA COLA %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_colas[id].nombre);
+
+	// Si no hay nadie que tenga abierta la cola, se elimina
+	if (open_cola_count(id) == 0) {
+		printk("\t\tSE ELIMINA LA COLA %d (%s), NINGUN PROCESO LA USA\n", id, tabla_colas[id].nombre);
+		eliminar_cola(id);
 	}
 
-	// Comprobar que queden huecos libres
-	ret = get_avail_mutex();
-	while (ret < 0) {
+	return 0;
+}
 
-		// Bloquar el proceso
-		p_proc_actual->estado=BLOQUEADO;
+/*
+ * Función que implementa la operación de reservar un buffer para
+ * un mensaje grande. Devuelve su direccion en *datos.
+ */
+int sis_reservar_mensaje(){
 
-		printk("[%f] \tPROCESO %d ESPERA A ELIMINAR UN MUTEX\n", (float) t_ticks/TICK, p_proc_actual->id);
+	// Variables
+	unsigned int tam;
+	void **datos;
+	int id;
 
-		// Siguiente proceso
-		siguiente_rodaja();
-		
-		// Comprobar de nuevo que no exista otro con ese nombre despues de la espera
-		ret = mutex_valid_name(nombre);
-		if (ret < 0) {
-			printk("[%f] \tAL DESPERTAR %d EXISTE UN MUTEX LLAMADO %s\n", (float) t_ticks/TICK, p_proc_actual->id, nombre);
-			return MUTEX_NAME_EXIST;
-		}
+	// Lectura de argumentos
+	tam=(unsigned int)leer_registro(1);
+	datos=(void **)leer_registro(2);
 
-		// Comprobar que siguen habiendo libres
-		ret = get_avail_mutex();
-	}
+	if (tam == 0 || tam > TAM_MAX_MSJ)
+		return COLA_BAD_SIZE;
 
-	// Inicializacion del mutex
-	id = get_avail_mutex();
-	m = &tabla_mutex[id];
-	m->estado = MTX_DESBLOQUEADO;
-	m->tipo = tipo;
-	m->nombre = strdup(nombre);
-	m->lista_bloqueados= (lista_BCPs) {NULL, NULL};
-	if (tipo == RECURSIVO) m->n_anidamiento = 0;
+	// Buscando una entrada libre en la tabla de buffers
+	for (id = 0; id < NUM_BUF_MSJ && tabla_buffers[id].datos != NULL; id++);
+	if (id == NUM_BUF_MSJ) {
+		printk("[%f] \tNO QUEDAN BUFFERS DE MENSAJE LIBRES\n", (float) t_ticks/TICK);
+		return COLA_SLAB_FULL;
+	}
 
-	printk("[%f] \tPROCESO %d CREA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, m->nombre);
+	if ((tabla_buffers[id].datos = malloc(tam)) == NULL) {
+		printk("[%f] \tNO HAY MEMORIA PARA UN MENSAJE DE %d BYTES\n", (float) t_ticks/TICK, tam);
+		return COLA_NO_MEMORY;
+	}
+	tabla_buffers[id].tam = tam;
+	tabla_buffers[id].dueno = p_proc_actual->id;
 
-	// Abriendo el mutex
-	escribir_registro(1, (long) nombre); // Paso de parametros
-	sis_abrir_mutex();
+	acc_param = 1;
+	*datos = tabla_buffers[id].datos;
+	acc_param = 0;
 
-	// Devolver descriptor
-	return id;
+	return 0;
 }
 
 /*
- * Función que implementa la operación de abrir un mutex de 
- * la cuarta funcionalidad a desarrollar (mutex).
+ * Función que implementa la operación de liberar un buffer de
+ * mensaje grande que posee el proceso.
  */
-int sis_abrir_mutex(){
+int sis_liberar_mensaje(){
 
 	// Variables
-	char* nombre;
-	int ret;
+	void *datos;
+	int id;
 
 	// Lectura de argumentos
-	nombre=(char*)leer_registro(1);
-
-	// Comprobar que el proceso puede tener mutex asignados
-	if (num_mutex_desc() >= NUM_MUT_PROC) {
-		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES\n", (float) t_ticks/TICK, p_proc_actual->id);
-		return MUTEX_MAX_DESC;
-	}
+	datos=(void *)leer_registro(1);
 
-	// Buscar el mutex
-	ret = mutex_search_name(nombre);
-	if (ret == MUTEX_NO_EXIST) {
-		// Error
-		printk("[%f] \tNO EXISTE EL MUTEX %s\n", (float) t_ticks/TICK, nombre);
-		return MUTEX_NO_EXIST;
-	}
+	id = buffer_search_dir(datos);
+	if (id < 0 || tabla_buffers[id].dueno != p_proc_actual->id)
+		return COLA_BAD_BUFFER;
 
-	// Asociando el descriptor al proceso
-	add_mutex_desc(ret);
-	
-	printk("[%f] \tPROCESO %d ABRE EL MUTEX %d (%s)\n", (float) t_ticks/TICK, sis_obtener_id_pr(), ret, tabla_mutex[ret].nombre);
+	eliminar_buffer(id);
 
-	return ret;
+	return 0;
 }
 
+/* Llamadas relacionadas con la memoria compartida */
 /*
- * Función que implementa la operación de bloquear un mutex de 
- * la cuarta funcionalidad a desarrollar (mutex).
+ * Función que implementa la operación de crear una region de memoria
+ * compartida. Como todas las imagenes comparten el espacio de
+ * direcciones, la region tiene la misma direccion en todos los
+ * procesos, que se devuelve en *dir.
  */
-int sis_lock(){
-	
+int sis_crear_memoria_compartida(){
+
 	// Variables
+	regionptr r;
+	char* nombre_usr;
+	char nombre[MAX_NOM_SHM];
+	unsigned int tam;
+	void **dir;
 	int id;
 
 	// Lectura de argumentos
-	id=(int)leer_registro(1);
+	nombre_usr=(char*)leer_registro(1);
+	tam=(unsigned int)leer_registro(2);
+	dir=(void **)leer_registro(3);
+
+	// Comprobar el tamaño de la region
+	if (tam == 0 || tam > TAM_MAX_SHM) {
+		printk("[%f] \tTAMAÑO DE REGION %d NO VALIDO\n", (float) t_ticks/TICK, tam);
+		return SHM_BAD_SIZE;
+	}
 
-	// Caso de que el mutex no se haya creado
-	if (tabla_mutex[id].estado == MTX_NO_USADO) {
-		printk("[%f] \tMUTEX %d NO CREADO\n", (float) t_ticks/TICK, id);
-		return MUTEX_NO_EXIST;
+	// Comprobar que el proceso puede tener regiones asignadas
+	if (num_shm_desc() >= NUM_SHM_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE REGION\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return SHM_MAX_DESC;
 	}
 
-	// Caso de que el proceso no tenga abierto el mutex
-	if (mutex_is_opened(id) < 0) {
-		printk("[%f] \tPROCESO %d NO TIENE EL MUTEX %d ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, id);
-		return MUTEX_CLOSED;
+	// Comprobar longitud del nombre y que no exista
+	if (leer_nombre(nombre, nombre_usr, MAX_NOM_SHM) < 0) {
+		printk("[%f] \tNOMBRE DE LA REGION DEMASIADO LARGO\n", (float) t_ticks/TICK);
+		return SHM_NAME_LONG;
+	}
+	if (shm_search_name(nombre) >= 0) {
+		printk("[%f] \tYA EXISTE UNA REGION LLAMADA %s\n", (float) t_ticks/TICK, nombre);
+		return SHM_NAME_EXIST;
 	}
 
-	// Caso de que el dueño del mutex lo quiera volver a tomar
-	if (tabla_mutex[id].p_id == sis_obtener_id_pr() && tabla_mutex[id].estado == MTX_BLOQUEADO) {
-		if (tabla_mutex[id].tipo == RECURSIVO) { 	// Si es recursivo -> se incrementa el nivel de anidamiento
-			tabla_mutex[id].n_anidamiento++;
-			printk("[%f] \tPROCESO %d VUELVE A TOMAR EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
-			printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
-		} else { 									// Si no es recursivo -> se devuelve un error
-			printk("[%f] \tPROCESO %d INTENTA TOMAR EL MUTEX NO RECURSIVO %d (%s)\n", 
-				(float) t_ticks/TICK, sis_obtener_id_pr(), id, tabla_mutex[id].nombre);
-			return MUTEX_LOCK_FAIL;
-		}
-	// Caso de que quien lo quiere tomar no sea el dueño
-	} else {
-		while (tabla_mutex[id].estado == MTX_BLOQUEADO){
-			// Bloquear el proceso
-			p_proc_actual->estado=BLOQUEADO_MTX;
+	// Comprobar que queden huecos libres
+	id = get_avail_shm();
+	if (id < 0) {
+		printk("[%f] \tNO QUEDAN REGIONES LIBRES\n", (float) t_ticks/TICK);
+		return SHM_TABLE_FULL;
+	}
 
-			printk("[%f] \tPROCESO %d ESPERA A LIBERAR MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+	// Inicializacion de la region
+	r = &tabla_shm[id];
+	r->nombre = strdup(nombre);
+	r->dir = calloc(1, tam);
+	if (r->nombre == NULL || r->dir == NULL) {
+		free(r->nombre);
+		free(r->dir);
+		r->nombre = NULL;
+		r->dir = NULL;
+		printk("[%f] \tNO HAY MEMORIA PARA UNA REGION DE %d BYTES\n", (float) t_ticks/TICK, tam);
+		return SHM_NO_MEMORY;
+	}
+	r->estado = SHM_USADA;
+	r->tam = tam;
+	r->n_refs = 0;
 
-			// Siguiente proceso
-			siguiente_rodaja();
-		}
+	printk("[%f] \tPROCESO %d CREA LA REGION %d (%s) DE %d BYTES\n", (float) t_ticks/TICK, p_proc_actual->id, id, r->nombre, tam);
 
-		// Se toma el mutex
-		tabla_mutex[id].estado = MTX_BLOQUEADO;
-		tabla_mutex[id].p_id = sis_obtener_id_pr();
+	// Asociando el descriptor al proceso
+	add_shm_desc(id);
 
-		printk("[%f] \tPROCESO %d TOMA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
-		if (tabla_mutex[id].tipo == RECURSIVO) {
-			tabla_mutex[id].n_anidamiento++;
-			printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
-		}
-	}
+	acc_param = 1;
+	*dir = r->dir;
+	acc_param = 0;
 
-	return 0;
+	return id;
 }
 
 /*
- * Función que implementa la operación de desbloquear un mutex de 
- * la cuarta funcionalidad a desarrollar (mutex).
+ * Función que implementa la operación de abrir una region de memoria
+ * compartida, devolviendo su direccion en *dir.
  */
-int sis_unlock(){
-	
+int sis_abrir_memoria_compartida(){
+
 	// Variables
+	char* nombre_usr;
+	char nombre[MAX_NOM_SHM] = "";
+	void **dir;
 	int id;
 
 	// Lectura de argumentos
-	id=(int)leer_registro(1);
+	nombre_usr=(char*)leer_registro(1);
+	dir=(void **)leer_registro(2);
 
-	// Caso de que el mutex no se haya creado
-	if (tabla_mutex[id].estado == MTX_NO_USADO) {
-		printk("[%f] \tMUTEX %d NO CREADO\n", (float) t_ticks/TICK, id);
-		return MUTEX_NO_EXIST;
+	// Comprobar que el proceso puede tener regiones asignadas
+	if (num_shm_desc() >= NUM_SHM_PROC) {
+		printk("[%f] \tPROCESO %d POSEE EL MAXIMO DE DESCRIPTORES DE REGION\n", (float) t_ticks/TICK, p_proc_actual->id);
+		return SHM_MAX_DESC;
 	}
 
-	// Comprobar que es dueño del mutex
-	if (sis_obtener_id_pr() != tabla_mutex[id].p_id) {
-		printk("[%f] \tPROCESO %d INTENTA LIBERAR EL MUTEX %d (%s) PERO NO LO POSEE (LO POSEE %d)\n", 
-			(float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre, tabla_mutex[id].p_id);
-		return MUTEX_UNLOCK_FAIL;
+	// Buscar la region
+	id = SHM_NO_EXIST;
+	if (leer_nombre(nombre, nombre_usr, MAX_NOM_SHM) >= 0)
+		id = shm_search_name(nombre);
+	if (id == SHM_NO_EXIST) {
+		printk("[%f] \tNO EXISTE LA REGION %s\n", (float) t_ticks/TICK, nombre);
+		return SHM_NO_EXIST;
 	}
 
-	printk("[%f] \tPROCESO %d LIBERA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
+	// Asociando el descriptor al proceso
+	add_shm_desc(id);
 
-	// Caso de que sea recursivo
-	if (tabla_mutex[id].tipo == RECURSIVO && tabla_mutex[id].n_anidamiento > 0) {
-		tabla_mutex[id].n_anidamiento--;
-		printk("\t\tNIVEL DE ANIDAMIENTO DEL MUTEX RECURSIVO: %d\n", (float) t_ticks/TICK, tabla_mutex[id].n_anidamiento);
-	}
+	printk("[%f] \tPROCESO %d ABRE LA REGION %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_shm[id].nombre);
 
-	// Sólo se libera realmente si el nivel de anidamiento es 0 o no es recursivo
-	if (tabla_mutex[id].tipo == NO_RECURSIVO || 
-		(tabla_mutex[id].tipo == RECURSIVO && tabla_mutex[id].n_anidamiento == 0)){
-		// Se libera el mutex
-		tabla_mutex[id].estado = MTX_DESBLOQUEADO;
+	acc_param = 1;
+	*dir = tabla_shm[id].dir;
+	acc_param = 0;
 
-		// Despertando proceso bloqueado a la espera de liberar el mutex si los hay
-		despierta_primero(&tabla_mutex[id].lista_bloqueados);
-	}
-	
-	return 0;
+	return id;
 }
 
 /*
- * Función que implementa la operación de cerrar un mutex de 
- * la cuarta funcionalidad a desarrollar (mutex).
+ * Función que implementa la operación de cerrar una region de memoria
+ * compartida. La region se libera al cerrarla su ultimo usuario.
  */
-int sis_cerrar_mutex(){
-	
+int sis_cerrar_memoria_compartida(){
+
 	// Variables
+	regionptr r;
 	int id;
 
 	// Lectura de argumentos
 	id=(int)leer_registro(1);
 
-	// Comprobando que el proceso tiene el mutex abierto
-	if (del_mutex_desc(id) == MUTEX_CLOSED) {
-		printk("[%f] \tPROCESO %d NO TIENE EL MUTEX %d (%s) ABIERTO\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
-		return MUTEX_CLOSED;
+	// Comprobando que el proceso tiene la region abierta
+	if (id < 0 || id >= NUM_SHM || del_shm_desc(id) == SHM_CLOSED) {
+		printk("[%f] \tPROCESO %d NO TIENE LA REGION %d ABIERTA\n", (float) t_ticks/TICK, p_proc_actual->id, id);
+		return SHM_CLOSED;
 	}
+	r = &tabla_shm[id];
 
-	printk("[%f] \tPROCESO %d CIERRA EL MUTEX %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, tabla_mutex[id].nombre);
-
-	// Si el dueño es quien lo cierra, se desbloquea
-	if (tabla_mutex[id].p_id == sis_obtener_id_pr() &&
-		tabla_mutex[id].estado == MTX_BLOQUEADO) {
-		// Reestablecemos el numero de anidamientos si es recursivo
-		if (tabla_mutex[id].tipo == RECURSIVO)
-			tabla_mutex[id].n_anidamiento = 1; // Lo ponemos a 1 para que unlock haga el decremento y el print
-		sis_unlock();
-	}
+	printk("[%f] \tPROCESO %d CIERRA LA REGION %d (%s)\n", (float) t_ticks/TICK, p_proc_actual->id, id, r->nombre);
 
-	// Si no hay nadie que tenga abierto el mutex, se elimnina
-	if (open_mutex_count(id) == 0) {
-		printk("\t\tSE ELIMINA EL MUTEX %d (%s), NINGUN PROCESO LO USA\n", id, tabla_mutex[id].nombre);
-		eliminar_mutex(id);
+	// Si no hay nadie que tenga abierta la region, se libera
+	if (r->n_refs == 0) {
+		printk("\t\tSE ELIMINA LA REGION %d (%s), NINGUN PROCESO LA USA\n", id, r->nombre);
+		free(r->nombre);
+		free(r->dir);
+		r->estado = SHM_NO_USADA;
 	}
 
 	return 0;
 }
 
-int sis_leer_caracter() {
+/* Llamadas relacionadas con la cache de imagenes */
+/*
+ * Función que devuelve los contadores de uso de la cache de imagenes.
+ */
+int sis_estadisticas_imagenes(){
 
 	// Variables
-	char ret;
-	int n_int, eval;
+	struct estad_imagenes *est;
 
-	// Inhibir interrupciones de terminal para evaluar condicion
-	n_int = fijar_nivel_int(NIVEL_2);
+	// Lectura de argumentos
+	est=(struct estad_imagenes *)leer_registro(1);
 
-	eval = start_char - read_chars; 
-	
-	// Deshinibir interrupciones de terminal
-	fijar_nivel_int(n_int);
+	if (est == NULL)
+		return -1;
 
-	// Caso de  que no queden caracteres en el buffer
-	while (eval >= 0) {
-		// Bloquar el proceso
-		p_proc_actual->estado=BLOQUEADO_TERM;
+	acc_param = 1;
+	*est = estad_cache;
+	acc_param = 0;
 
-		printk("[%f] \tPROCESO %d ESPERA A LEER UN CARACTER\n", (float) t_ticks/TICK, p_proc_actual->id);
+	return 0;
+}
 
-		// Siguiente proceso
-		siguiente_rodaja();
+/*
+ * Función que descarga las imagenes residentes que no usa ningun proceso.
+ */
+int sis_vaciar_cache_imagenes(){
 
-		// Inhibir interrupciones de terminal para evaluar condicion
-		n_int = fijar_nivel_int(NIVEL_2);
+	printk("[%f] \tPROCESO %d VACIA LA CACHE DE IMAGENES\n", (float) t_ticks/TICK, p_proc_actual->id);
+	vaciar_cache_imagenes();
 
-		eval = start_char - read_chars; 
-		
-		// Deshinibir interrupciones de terminal
-		fijar_nivel_int(n_int);
-	}
+	return 0;
+}
 
-	// Leemos el caracter
-	ret = char_buff[start_char % TAM_BUF_TERM];
-	start_char++;
+/*
+ * Función que devuelve los contadores de uso del pool de pilas.
+ */
+int sis_estadisticas_pilas(){
 
-	return ret;
+	// Variables
+	struct estad_pilas *est;
+
+	// Lectura de argumentos
+	est=(struct estad_pilas *)leer_registro(1);
+
+	if (est == NULL)
+		return -1;
+
+	acc_param = 1;
+	*est = estad_pool;
+	acc_param = 0;
+
+	return 0;
 }
 
 /*
@@ -1098,9 +4692,14 @@ int main(){
 
 	iniciar_cont_int();			/* inicia cont. interr. */
 	iniciar_cont_reloj(TICK);	/* fija frecuencia del reloj */
+	t_arranque_ns = reloj_ns();	/* origen de obtener_tiempo_ns */
 	iniciar_cont_teclado();		/* inici cont. teclado */
 
+	iniciar_planificador();		/* elige la clase de los no periodicos */
+	iniciar_datos_kernel();		/* crea la pagina de datos del kernel */
 	iniciar_tabla_proc();		/* inicia BCPs de tabla de procesos */
+	iniciar_slab_mensajes();	/* inicia el slab de mensajes */
+	iniciar_pool_pilas();		/* reserva las pilas iniciales */
 
 	/* crea proceso inicial */
 	if (crear_tarea((void *)"init")<0)
@@ -1108,6 +4707,7 @@ int main(){
 	
 	/* activa proceso inicial */
 	p_proc_actual=planificador();
+	actualizar_datos_kernel();
 	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
 	panico("S.O. reactivado inesperadamente");
 	return 0;
@@ -0,0 +1,48 @@
+/*
+ * usuario/bench/bench.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que ejecuta, uno tras otro, todos los programas de
+ * medida del directorio bench. La medida del terminal va la ultima, ya
+ * que espera a que se le introduzcan los caracteres (bench/terminal.sh
+ * los teclea sin que haga falta una persona).
+ */
+
+#include "bench.h"
+
+static char *pruebas[] = {
+	"bench/llamsis_nula",
+	"bench/cambio_contexto",
+	"bench/mutex",
+	"bench/spawn",
+	"bench/dormir",
+	"bench/terminal"
+};
+
+int main(){
+	unsigned long long t0;
+	int i, id, estado;
+
+	printf("bench: comienza\n");
+	t0=obtener_tiempo_ns();
+
+	for (i=0; i<sizeof(pruebas)/sizeof(pruebas[0]); i++) {
+		if ((id=crear_proceso(pruebas[i]))<0) {
+			printf("bench: error creando %s\n", pruebas[i]);
+			continue;
+		}
+		esperar_proceso(id, &estado);
+		if (estado==FIN_POR_EXCEPCION)
+			printf("bench: %s termina por excepcion\n", pruebas[i]);
+	}
+
+	informar("bench", "duracion_ms", (obtener_tiempo_ns()-t0)/1000000);
+	printf("bench: termina\n");
+	return 0;
+}
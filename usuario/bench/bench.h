@@ -0,0 +1,30 @@
+/*
+ *  usuario/bench/bench.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera comun de los programas de medida. Cada resultado
+ * se escribe en una linea con el formato
+ *
+ *	BENCH <prueba> <metrica> <valor>
+ *
+ * donde la metrica lleva la unidad en el nombre (p.ej. latencia_ns) y el
+ * valor es un entero, para poder extraerlos de la salida con grep/awk.
+ *
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include "servicios.h"
+
+#define informar(prueba, metrica, valor) \
+	printf("BENCH %s %s %llu\n", (prueba), (metrica), (unsigned long long)(valor))
+
+#endif /* _BENCH_H */
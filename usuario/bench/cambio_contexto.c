@@ -0,0 +1,57 @@
+/*
+ * usuario/bench/cambio_contexto.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida del cambio de contexto: intercambia mensajes
+ * vacios con un eco_cola por las colas "ida" y "vuelta". Cada ida y
+ * vuelta supone dos cambios de contexto (y un enviar y un recibir en
+ * cada proceso).
+ */
+
+#include "bench.h"
+
+#define NUM_VUELTAS 20000
+
+int main(){
+	unsigned long long t0, t1;
+	int ida, vuelta, i;
+	char c=0;
+	struct mensaje msj;
+
+	if ((ida=crear_cola("ida", 1))<0 || (vuelta=crear_cola("vuelta", 1))<0) {
+		printf("cambio_contexto: error creando las colas\n");
+		return 0;
+	}
+	if (crear_proceso("eco_cola")<0) {
+		printf("cambio_contexto: error creando eco_cola\n");
+		return 0;
+	}
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_VUELTAS; i++) {
+		msj.datos=&c;
+		msj.tam=1;
+		msj.prioridad=0;
+		enviar(ida, &msj, ESPERA_INDEFINIDA);
+		msj.tam=1;
+		recibir(vuelta, &msj, ESPERA_INDEFINIDA);
+	}
+	t1=obtener_tiempo_ns();
+
+	/* un mensaje vacio termina el eco */
+	msj.tam=0;
+	enviar(ida, &msj, ESPERA_INDEFINIDA);
+	esperar_proceso(CUALQUIER_HIJO, 0);
+	cerrar_cola(ida);
+	cerrar_cola(vuelta);
+
+	informar("cambio_contexto", "ida_y_vuelta_ns", (t1-t0)/NUM_VUELTAS);
+	informar("cambio_contexto", "cambio_ns", (t1-t0)/NUM_VUELTAS/2);
+	return 0;
+}
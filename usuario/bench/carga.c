@@ -0,0 +1,133 @@
+/*
+ * usuario/bench/carga.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Generador de carga parametrizable. Lanza una mezcla de procesos
+ * (carga_hijo) durante un tiempo y da el rendimiento y la latencia de
+ * cada clase. Se configura con los argumentos de crear_proceso_args
+ * (parejas nombre=valor; los que falten toman el valor por defecto):
+ *
+ *	cpu=N		procesos de calculo (2)
+ *	uso_cpu=%	parte de cada periodo que calculan (100)
+ *	io=M		procesos que calculan poco y duermen (2)
+ *	uso_io=%	parte de cada periodo que calculan (10)
+ *	periodo=T	ticks del ciclo de calculo y sueño (10)
+ *	cerrojo=K	procesos que compiten por un mutex (2)
+ *	retencion_us	tiempo que retienen el mutex (100)
+ *	pausa_us	tiempo entre que lo sueltan y lo vuelven a pedir (500)
+ *	duracion=D	ticks que dura la prueba (500)
+ *
+ * p.ej. crear_proceso_args("bench/carga", "cpu=4 io=8 uso_io=5 cerrojo=0").
+ * Los resultados salen en el formato de los programas de medida.
+ */
+
+#include "bench.h"
+#include "carga.h"
+
+/* Suma los resultados de los procesos de un tipo */
+static void resumir(struct region_carga *reg, int n, int tipo, unsigned long long ns,
+	char *prueba, char *ops, char *lat){
+	unsigned long long total=0, cuad=0, lat_total=0, lat_max=0;
+	int i, m=0;
+
+	for (i=0; i<n; i++) {
+		if (reg->res[i].tipo!=tipo)
+			continue;
+		m++;
+		total+=reg->res[i].ops;
+		cuad+=(unsigned long long)reg->res[i].ops*reg->res[i].ops;
+		lat_total+=reg->res[i].lat_total_us;
+		if (reg->res[i].lat_max_us > lat_max)
+			lat_max=reg->res[i].lat_max_us;
+	}
+	if (m==0)
+		return;
+
+	printf("BENCH %s procesos %d\n", prueba, m);
+	printf("BENCH %s %s_por_s %llu\n", prueba, ops, total*1000000000ULL/ns);
+	if (lat) {
+		printf("BENCH %s %s_medio_us %llu\n", prueba, lat, total>0 ? lat_total/total : 0);
+		printf("BENCH %s %s_max_us %llu\n", prueba, lat, lat_max);
+	} else if (cuad>0)
+		/* indice de Jain: 1000 es reparto perfecto */
+		printf("BENCH %s equidad %llu\n", prueba, total*total*1000/(m*cuad));
+}
+
+int main(){
+	char args[TAM_ARGUMENTOS], hijo[TAM_ARGUMENTOS];
+	struct region_carga *reg;
+	int ncpu, nio, ncerrojo, uso_cpu, uso_io, periodo, retencion, pausa, duracion;
+	int shm, mut=-1, n, i;
+	unsigned long long t0, ns;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	ncpu=argumento_entero(args, "cpu", 2);
+	uso_cpu=argumento_entero(args, "uso_cpu", 100);
+	nio=argumento_entero(args, "io", 2);
+	uso_io=argumento_entero(args, "uso_io", 10);
+	periodo=argumento_entero(args, "periodo", 10);
+	ncerrojo=argumento_entero(args, "cerrojo", 2);
+	retencion=argumento_entero(args, "retencion_us", 100);
+	pausa=argumento_entero(args, "pausa_us", 500);
+	duracion=argumento_entero(args, "duracion", 500);
+
+	printf("carga: comienza (%s)\n", args);
+	if (ncpu+nio+ncerrojo > MAX_HIJOS_CARGA || uso_cpu>100 || uso_io>100 || periodo==0) {
+		printf("carga: configuracion no valida\n");
+		return 0;
+	}
+	if ((shm=crear_memoria_compartida("carga", sizeof(*reg), (void **)&reg))<0) {
+		printf("carga: error creando la region\n");
+		return 0;
+	}
+	if (ncerrojo>0 && (mut=crear_mutex("carga", NO_RECURSIVO))<0) {
+		printf("carga: error creando el mutex\n");
+		cerrar_memoria_compartida(shm);
+		return 0;
+	}
+	reg->fin=0;
+
+	for (n=0; n<ncpu+nio+ncerrojo; n++) {
+		hijo[0]='\0';
+		poner_argumento(hijo, TAM_ARGUMENTOS, "n", n);
+		if (n<ncpu) {
+			poner_argumento(hijo, TAM_ARGUMENTOS, "tipo", CARGA_CPU);
+			poner_argumento(hijo, TAM_ARGUMENTOS, "uso", uso_cpu);
+		} else if (n<ncpu+nio) {
+			poner_argumento(hijo, TAM_ARGUMENTOS, "tipo", CARGA_IO);
+			poner_argumento(hijo, TAM_ARGUMENTOS, "uso", uso_io);
+		} else {
+			poner_argumento(hijo, TAM_ARGUMENTOS, "tipo", CARGA_CERROJO);
+			poner_argumento(hijo, TAM_ARGUMENTOS, "retencion_us", retencion);
+			poner_argumento(hijo, TAM_ARGUMENTOS, "pausa_us", pausa);
+		}
+		poner_argumento(hijo, TAM_ARGUMENTOS, "periodo", periodo);
+		reg->res[n].tipo=-1;
+		if (crear_proceso_args("bench/carga_hijo", hijo)<0)
+			printf("carga: error creando carga_hijo (%s)\n", hijo);
+	}
+
+	t0=obtener_tiempo_ns();
+	dormir_ticks(duracion);
+	reg->fin=1;
+	ns=obtener_tiempo_ns()-t0;
+	for (i=0; i<n; i++)
+		esperar_proceso(CUALQUIER_HIJO, 0);
+
+	informar("carga", "duracion_ms", ns/1000000);
+	resumir(reg, n, CARGA_CPU, ns, "carga_cpu", "tandas", 0);
+	resumir(reg, n, CARGA_IO, ns, "carga_io", "periodos", "retraso");
+	resumir(reg, n, CARGA_CERROJO, ns, "carga_cerrojo", "adquisiciones", "espera");
+
+	if (mut>=0)
+		cerrar_mutex(mut);
+	cerrar_memoria_compartida(shm);
+	printf("carga: termina\n");
+	return 0;
+}
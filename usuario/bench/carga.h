@@ -0,0 +1,43 @@
+/*
+ *  usuario/bench/carga.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera comun del generador de carga (carga) y de sus
+ * procesos (carga_hijo), que se comunican por la region "carga".
+ *
+ */
+
+#ifndef _CARGA_H
+#define _CARGA_H
+
+#define MAX_HIJOS_CARGA 32
+
+/* Tipos de proceso de carga */
+#define CARGA_CPU 0			/* calcula uso% de cada periodo y duerme el resto */
+#define CARGA_IO 1			/* igual, con un uso bajo: mide el retraso al despertar */
+#define CARGA_CERROJO 2		/* coge un mutex, lo retiene y lo suelta */
+
+#define TANDA_CARGA 10000	/* iteraciones de calculo entre consultas del reloj */
+
+/* Resultado de un proceso de carga */
+struct res_carga {
+	int tipo;
+	unsigned int ops;				/* tandas, periodos o adquisiciones */
+	unsigned long long lat_total_us;	/* retraso al despertar o espera por el mutex */
+	unsigned long long lat_max_us;
+};
+
+/* Region compartida entre el generador y sus procesos */
+struct region_carga {
+	int fin;						/* lo pone el generador al acabar la prueba */
+	struct res_carga res[MAX_HIJOS_CARGA];
+};
+
+#endif /* _CARGA_H */
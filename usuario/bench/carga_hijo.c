@@ -0,0 +1,127 @@
+/*
+ * usuario/bench/carga_hijo.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Proceso del generador de carga. Sus argumentos (puestos por carga)
+ * son tipo, n (su resultado en la region), periodo (ticks), uso (% de
+ * cada periodo que calcula), retencion_us y pausa_us (mutex). Trabaja
+ * hasta que el generador marca el fin y deja su resultado en la region.
+ */
+
+#include "bench.h"
+#include "carga.h"
+
+static struct region_carga *reg;
+static const struct datos_kernel *datos;
+
+/* Calcula hasta el tick t_fin o hasta el fin de la prueba */
+static unsigned int calcular(int t_fin){
+	volatile int k;
+	unsigned int n=0;
+
+	while (!reg->fin && tiempos_proceso(0) < t_fin) {
+		for (k=0; k<TANDA_CARGA; k++);
+		n++;
+	}
+	return n;
+}
+
+/* Anota una latencia en us */
+static void anotar(struct res_carga *r, unsigned long long us){
+	r->lat_total_us+=us;
+	if (us > r->lat_max_us)
+		r->lat_max_us=us;
+}
+
+/* ns pasados desde el tick t (ya ocurrido), a partir del instante del
+   ultimo tick que publica la pagina de datos */
+static unsigned long long desde_tick(unsigned int t){
+	volatile const struct datos_kernel *d=datos;
+	unsigned long long ticks, tick_ns, ahora;
+	unsigned int sec;
+
+	do {
+		sec=d->secuencia;
+		ticks=d->ticks;
+		tick_ns=d->tick_ns;
+	} while ((sec & 1) || sec!=d->secuencia);
+	ahora=obtener_tiempo_ns();
+
+	/* los ticks anteriores al ultimo se suponen de 1/TICK s */
+	if (ticks>t)
+		tick_ns-=(ticks-t)*(1000000000ULL/TICK);
+	return ahora>tick_ns ? ahora-tick_ns : 0;
+}
+
+/* Espera activa de us microsegundos */
+static void retener(unsigned int us){
+	unsigned long long t0=obtener_tiempo_ns();
+
+	while (obtener_tiempo_ns()-t0 < us*1000ULL);
+}
+
+int main(){
+	char args[TAM_ARGUMENTOS];
+	struct res_carga r;
+	int shm, mut=-1, n, periodo, uso, retencion, pausa, t, t_ini;
+	unsigned long long t0;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	r.tipo=argumento_entero(args, "tipo", CARGA_CPU);
+	n=argumento_entero(args, "n", 0);
+	periodo=argumento_entero(args, "periodo", 10);
+	uso=argumento_entero(args, "uso", 100);
+	retencion=argumento_entero(args, "retencion_us", 100);
+	pausa=argumento_entero(args, "pausa_us", 500);
+	r.ops=0;
+	r.lat_total_us=r.lat_max_us=0;
+
+	if (datos_kernel(&datos)<0 ||
+		(shm=abrir_memoria_compartida("carga", (void **)&reg))<0 || n>=MAX_HIJOS_CARGA) {
+		printf("carga_hijo: error abriendo la region\n");
+		return 0;
+	}
+	if (r.tipo==CARGA_CERROJO && (mut=abrir_mutex("carga"))<0) {
+		printf("carga_hijo: error abriendo el mutex\n");
+		cerrar_memoria_compartida(shm);
+		return 0;
+	}
+
+	while (!reg->fin) {
+		if (r.tipo==CARGA_CERROJO) {
+			t0=obtener_tiempo_ns();
+			lock(mut);
+			anotar(&r, (obtener_tiempo_ns()-t0)/1000);
+			retener(retencion);
+			unlock(mut);
+			r.ops++;
+			retener(pausa);
+			continue;
+		}
+
+		/* un periodo: calcula uso% y duerme hasta el siguiente */
+		t_ini=tiempos_proceso(0);
+		t=calcular(t_ini+periodo*uso/100);
+		if (r.tipo==CARGA_CPU)
+			r.ops+=t;
+		if (uso<100 && !reg->fin) {
+			dormir_hasta(t_ini+periodo);
+			if (r.tipo==CARGA_IO)
+				anotar(&r, desde_tick(t_ini+periodo)/1000);
+		}
+		if (r.tipo==CARGA_IO)
+			r.ops++;
+	}
+
+	reg->res[n]=r;
+	if (mut>=0)
+		cerrar_mutex(mut);
+	cerrar_memoria_compartida(shm);
+	return 0;
+}
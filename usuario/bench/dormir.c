@@ -0,0 +1,66 @@
+/*
+ * usuario/bench/dormir.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida de la precision de dormir: para varias duraciones
+ * (en ticks con dormir_ticks y en segundos con dormir) mide cuanto dura
+ * de verdad la espera: minimo, medio y maximo frente a lo pedido. Como
+ * el despertar se produce en un tick, una espera de n ticks puede durar
+ * algo menos de n ticks si empieza a mitad de uno.
+ */
+
+#include "bench.h"
+
+#define REPETICIONES 20
+#define US_TICK (1000000/TICK)
+
+static unsigned int duraciones[] = {1, 2, 5, 10};
+
+/* Escribe un resultado de la espera de ticks ticks (segs segundos si no es 0) */
+static void informar_espera(unsigned int ticks, unsigned int segs, char *metrica,
+	unsigned long long valor){
+	if (segs)
+		printf("BENCH dormir_%u %s %llu\n", segs, metrica, valor);
+	else
+		printf("BENCH dormir_ticks_%u %s %llu\n", ticks, metrica, valor);
+}
+
+/* Duerme reps veces ticks ticks (segs segundos si no es 0) */
+static void medir(unsigned int ticks, unsigned int segs, int reps){
+	unsigned long long t0, t, total=0, min=~0ULL, max=0;
+	int i;
+
+	for (i=0; i<reps; i++) {
+		t0=obtener_tiempo_ns();
+		if (segs)
+			dormir(segs);
+		else
+			dormir_ticks(ticks);
+		t=(obtener_tiempo_ns()-t0)/1000;
+		total+=t;
+		if (t<min)
+			min=t;
+		if (t>max)
+			max=t;
+	}
+
+	informar_espera(ticks, segs, "pedido_us", segs ? segs*1000000ULL : (unsigned long long)ticks*US_TICK);
+	informar_espera(ticks, segs, "min_us", min);
+	informar_espera(ticks, segs, "medio_us", total/reps);
+	informar_espera(ticks, segs, "max_us", max);
+}
+
+int main(){
+	int i;
+
+	for (i=0; i<sizeof(duraciones)/sizeof(duraciones[0]); i++)
+		medir(duraciones[i], 0, REPETICIONES);
+	medir(0, 1, 2);
+	return 0;
+}
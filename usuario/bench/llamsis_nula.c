@@ -0,0 +1,39 @@
+/*
+ * usuario/bench/llamsis_nula.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida de la latencia de una llamada al sistema nula.
+ * obtener_id_pr ya no entra en el kernel (lee la pagina de datos), asi
+ * que la llamada nula que se mide es datos_kernel, que solo devuelve
+ * un puntero. Se mide tambien obtener_id_pr para comparar.
+ */
+
+#include "bench.h"
+
+#define NUM_LLAMADAS 200000
+
+int main(){
+	const struct datos_kernel *d;
+	unsigned long long t0, t1;
+	int i;
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_LLAMADAS; i++)
+		datos_kernel(&d);
+	t1=obtener_tiempo_ns();
+	informar("llamsis_nula", "latencia_ns", (t1-t0)/NUM_LLAMADAS);
+	informar("llamsis_nula", "llamadas_por_s", NUM_LLAMADAS*1000000000ULL/(t1-t0));
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_LLAMADAS; i++)
+		obtener_id_pr();
+	t1=obtener_tiempo_ns();
+	informar("obtener_id_pr", "latencia_ns", (t1-t0)/NUM_LLAMADAS);
+	return 0;
+}
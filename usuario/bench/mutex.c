@@ -0,0 +1,60 @@
+/*
+ * usuario/bench/mutex.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida de lock/unlock. Sin contienda, un solo proceso
+ * repite la pareja. Con contienda, NUM_HIJOS procesos (mutex_hijo) la
+ * repiten cediendo el procesador con el mutex cogido, de modo que cada
+ * lock encuentra el mutex ocupado y cada unlock despierta a un proceso
+ * bloqueado.
+ */
+
+#include "bench.h"
+
+#define NUM_PAREJAS 20000
+#define NUM_HIJOS 4
+#define PAREJAS_HIJO 500	/* se le pasan a cada mutex_hijo como argumento */
+
+int main(){
+	char args[TAM_ARGUMENTOS]="";
+	unsigned long long t0, t1;
+	int mut, i;
+
+	if ((mut=crear_mutex("bench", NO_RECURSIVO))<0) {
+		printf("mutex: error creando el mutex\n");
+		return 0;
+	}
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_PAREJAS; i++) {
+		lock(mut);
+		unlock(mut);
+	}
+	t1=obtener_tiempo_ns();
+	informar("mutex_sin_contienda", "pareja_ns", (t1-t0)/NUM_PAREJAS);
+
+	/* los hijos abren el mutex y se bloquean en el primer lock */
+	lock(mut);
+	poner_argumento(args, TAM_ARGUMENTOS, "parejas", PAREJAS_HIJO);
+	for (i=0; i<NUM_HIJOS; i++)
+		if (crear_proceso_args("bench/mutex_hijo", args)<0)
+			printf("mutex: error creando mutex_hijo\n");
+	dormir_ticks(5);
+
+	t0=obtener_tiempo_ns();
+	unlock(mut);
+	for (i=0; i<NUM_HIJOS; i++)
+		esperar_proceso(CUALQUIER_HIJO, 0);
+	t1=obtener_tiempo_ns();
+	informar("mutex_con_contienda", "procesos", NUM_HIJOS);
+	informar("mutex_con_contienda", "pareja_ns", (t1-t0)/(NUM_HIJOS*PAREJAS_HIJO));
+
+	cerrar_mutex(mut);
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * usuario/bench/mutex_hijo.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que usa bench/mutex para provocar contienda:
+ * repite lock/unlock sobre el mutex "bench" cediendo el procesador
+ * mientras lo tiene, tantas veces como indica su argumento parejas.
+ */
+
+#include "bench.h"
+
+int main(){
+	char args[TAM_ARGUMENTOS];
+	int mut, i, parejas;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	parejas=argumento_entero(args, "parejas", 0);
+
+	if ((mut=abrir_mutex("bench"))<0) {
+		printf("mutex_hijo: error abriendo el mutex\n");
+		return 0;
+	}
+	for (i=0; i<parejas; i++) {
+		lock(mut);
+		ceder_procesador();
+		unlock(mut);
+	}
+	cerrar_mutex(mut);
+	return 0;
+}
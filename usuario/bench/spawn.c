@@ -0,0 +1,51 @@
+/*
+ * usuario/bench/spawn.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida de la creacion y terminacion de procesos: crea
+ * NUM_PROCESOS procesos que terminan nada mas empezar (vacio), de uno
+ * en uno esperando a cada uno, y despues en tandas con crear_procesos.
+ */
+
+#include "bench.h"
+
+#define NUM_PROCESOS 500
+#define TANDA 50
+
+int main(){
+	unsigned long long t0, t1;
+	int ids[TANDA];
+	int i, j;
+
+	/* la primera carga la imagen en la cache */
+	if (crear_proceso("bench/vacio")<0) {
+		printf("spawn: error creando vacio\n");
+		return 0;
+	}
+	esperar_proceso(CUALQUIER_HIJO, 0);
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_PROCESOS; i++) {
+		crear_proceso("bench/vacio");
+		esperar_proceso(CUALQUIER_HIJO, 0);
+	}
+	t1=obtener_tiempo_ns();
+	informar("spawn", "crear_y_esperar_ns", (t1-t0)/NUM_PROCESOS);
+	informar("spawn", "procesos_por_s", NUM_PROCESOS*1000000000ULL/(t1-t0));
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<NUM_PROCESOS; i+=TANDA) {
+		crear_procesos("bench/vacio", TANDA, ids);
+		for (j=0; j<TANDA; j++)
+			esperar_proceso(CUALQUIER_HIJO, 0);
+	}
+	t1=obtener_tiempo_ns();
+	informar("spawn_tandas", "crear_y_esperar_ns", (t1-t0)/NUM_PROCESOS);
+	return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * usuario/bench/terminal.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de medida de la lectura del terminal con entrada preparada:
+ * la secuencia 0123456789 repetida y terminada en '.'. Mide el ritmo de
+ * lectura desde el primer caracter hasta el '.' y cuenta los que se han
+ * perdido (saltos en la secuencia, p.ej. por llenarse el buffer del
+ * terminal). El HAL produce una interrupcion por cada escritura en su
+ * entrada, asi que los caracteres deben escribirse de uno en uno, como
+ * hace bench/terminal.sh, que arranca el sistema y teclea la secuencia.
+ */
+
+#include "bench.h"
+
+#define MAX_CARACTERES 100000
+
+int main(){
+	unsigned long long t0, t1;
+	int n, perdidos=0, c, esperado;
+
+	printf("terminal: esperando la secuencia 0123456789... terminada en '.'\n");
+	if ((c=leer_caracter())=='.') {
+		informar("terminal", "caracteres", 0);
+		return 0;
+	}
+	t0=obtener_tiempo_ns();
+	for (n=1; n<MAX_CARACTERES; n++) {
+		esperado=(c=='9') ? '0' : c+1;
+		if ((c=leer_caracter())=='.')
+			break;
+		if (c!=esperado)
+			perdidos+=(c-esperado+10)%10;
+	}
+	t1=obtener_tiempo_ns();
+
+	informar("terminal", "caracteres", n);
+	informar("terminal", "perdidos", perdidos);
+	informar("terminal", "caracteres_por_s", t1>t0 ? n*1000000000ULL/(t1-t0) : 0);
+	return 0;
+}
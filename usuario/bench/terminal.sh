@@ -0,0 +1,64 @@
+#!/bin/sh
+#
+# usuario/bench/terminal.sh
+#	Teclea la entrada de bench/terminal para que la medida no dependa
+#	de una persona. Arranca el sistema (con el init que lance bench/bench
+#	o bench/terminal) en un terminal de script(1), espera a que
+#	bench/terminal pida la secuencia y la escribe de caracter en
+#	caracter, ya que el HAL da una interrupcion por cada escritura.
+#
+#	Uso, desde el directorio raiz:
+#		usuario/bench/terminal.sh [caracteres [pausa_s [espera_s]]]
+#
+#	caracteres	longitud de la secuencia 0123456789... (1000)
+#	pausa_s		pausa entre caracteres, en segundos (0.002)
+#	espera_s	maximo que se espera a cada fase, en segundos (120)
+#
+#	Deja la salida completa en bench_terminal.log y muestra las lineas
+#	BENCH.
+#
+
+CARACTERES=${1:-1000}
+PAUSA=${2:-0.002}
+ESPERA=${3:-120}
+SALIDA=bench_terminal.log
+
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+mkfifo "$DIR/entrada" || exit 1
+
+# Espera, como mucho ESPERA segundos, a que la salida contenga $1
+esperar_linea() {
+	t=0
+	while ! grep -aq "$1" "$SALIDA"; do
+		kill -0 "$SISTEMA" 2>/dev/null || return 1
+		[ "$t" -ge $((ESPERA * 10)) ] && return 1
+		sleep 0.1
+		t=$((t + 1))
+	done
+}
+
+# El descriptor 3 mantiene abierta la entrada mientras se teclea
+script -qfc "boot/boot minikernel/kernel" /dev/null < "$DIR/entrada" > "$SALIDA" 2>&1 &
+SISTEMA=$!
+exec 3> "$DIR/entrada"
+
+if ! esperar_linea "terminal: esperando"; then
+	echo "terminal.sh: bench/terminal no llega a pedir la secuencia (ver $SALIDA)" >&2
+	kill "$SISTEMA" 2>/dev/null
+	exit 1
+fi
+
+i=0
+while [ "$i" -lt "$CARACTERES" ]; do
+	printf '%d' $((i % 10)) >&3
+	sleep "$PAUSA"
+	i=$((i + 1))
+done
+printf '.' >&3
+
+esperar_linea "BENCH terminal caracteres_por_s"
+exec 3>&-
+kill "$SISTEMA" 2>/dev/null
+wait "$SISTEMA" 2>/dev/null
+grep -a "^BENCH" "$SALIDA"
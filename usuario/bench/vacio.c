@@ -0,0 +1,19 @@
+/*
+ * usuario/bench/vacio.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que termina nada mas empezar (para bench/spawn).
+ */
+
+#include "servicios.h"
+
+int main(){
+	terminar_proceso();
+	return 0; /* No se deberia llegar a este punto */
+}
@@ -0,0 +1,43 @@
+/*
+ * usuario/caliente.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario con un reparto de trabajo conocido para probar
+ * el perfilador: en cada ronda trabajo_grande hace tres veces las
+ * iteraciones de trabajo_pequeno, asi que su perfil (perfil) debe
+ * repartirse 3 a 1 entre ellas.
+ */
+
+#include "servicios.h"
+
+#define RONDAS 100
+#define ITERACIONES 5000000
+
+static void trabajo_pequeno(int n){
+	volatile int k;
+
+	for (k=0; k<n; k++);
+}
+
+static void trabajo_grande(int n){
+	volatile int k;
+
+	for (k=0; k<n; k++);
+}
+
+int main(){
+	int i;
+
+	for (i=0; i<RONDAS; i++) {
+		trabajo_grande(3*ITERACIONES);
+		trabajo_pequeno(ITERACIONES);
+	}
+	printf("caliente: termina\n");
+	return 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * usuario/cedente.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que solo cede el procesador TOT_CESIONES veces.
+ */
+
+#include "servicios.h"
+
+#define TOT_CESIONES 10000
+
+int main(){
+	int i;
+
+	for (i=0; i<TOT_CESIONES; i++)
+		ceder_procesador();
+	return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ *  usuario/datos_shm.h
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero de cabecera comun de prueba_shm y de sus procesos
+ * sumador_shm, que se comunican por la region "datos".
+ *
+ */
+
+#ifndef _DATOS_SHM_H
+#define _DATOS_SHM_H
+
+#define NUM_ENTEROS 10000	/* enteros que contiene la region */
+
+/* Region compartida entre prueba_shm y los sumadores */
+struct datos_compartidos {
+	int n_terminados;
+	int suma;
+	int valores[NUM_ENTEROS];
+};
+
+#endif /* _DATOS_SHM_H */
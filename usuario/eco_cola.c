@@ -0,0 +1,42 @@
+/*
+ * usuario/eco_cola.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que devuelve por la cola "vuelta" cada mensaje
+ * que recibe por la cola "ida", hasta recibir un mensaje vacio.
+ */
+
+#include "servicios.h"
+
+int main(){
+	int id, ida, vuelta, n=0;
+	char buf[TAM_MSJ_PEQ];
+	struct mensaje msj;
+
+	id=obtener_id_pr();
+	if ((ida=abrir_cola("ida"))<0 || (vuelta=abrir_cola("vuelta"))<0) {
+		printf("eco_cola (%d): error abriendo las colas\n", id);
+		return 0;
+	}
+
+	for (;;) {
+		msj.datos=buf;
+		msj.tam=TAM_MSJ_PEQ;
+		if (recibir(ida, &msj, ESPERA_INDEFINIDA)<=0)
+			break;
+
+		/* un mensaje grande se devuelve cediendo el mismo buffer */
+		if (enviar(vuelta, &msj, ESPERA_INDEFINIDA)<0)
+			break;
+		n++;
+	}
+
+	printf("eco_cola (%d): termina tras devolver %d mensajes\n", id, n);
+	return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * usuario/hijo_estado.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que termina con un estado conocido por su
+ * creador: los dos ultimos digitos de su id.
+ */
+
+#include "servicios.h"
+
+int main(){
+	salir(obtener_id_pr() % 100);
+
+	/* No deberia llegar */
+	printf("hijo_estado: sigue tras salir. NO DEBE APARECER\n");
+	return 0;
+}
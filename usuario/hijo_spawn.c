@@ -0,0 +1,21 @@
+/*
+ * usuario/hijo_spawn.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que solo avisa a su creador de que ha
+ * ejecutado, escribiendo un byte en el pipe heredado en el
+ * descriptor 0.
+ */
+
+#include "servicios.h"
+
+int main(){
+	escribir_pipe(0, "x", 1);
+	return 0;
+}
@@ -19,6 +19,10 @@
 #ifndef SERVICIOS_H
 #define SERVICIOS_H
 
+/* Constantes y estados de proceso compartidos con el kernel */
+#include "const.h"
+#include "estados.h"
+
 /* Evita el uso del printf de la bilioteca est�ndar */
 #define printf escribirf
 
@@ -26,6 +30,13 @@
 #define NO_RECURSIVO 0
 #define RECURSIVO 1
 
+/* Definicion de los modos de acceso a un pipe (se pueden combinar) */
+#define PIPE_BLOQUEANTE 0
+#define PIPE_NO_BLOQUEANTE 1
+#define PIPE_SOLO_LECTURA 2		/* el descriptor es un extremo de lectura */
+#define PIPE_SOLO_ESCRITURA 4	/* el descriptor es un extremo de escritura */
+#define PIPE_NO_HEREDAR 8		/* los hijos no heredan el descriptor */
+
 /*
  *
  * Definici�n del tipo que corresponde con la entrada para la función tiempos_proceso().
@@ -36,6 +47,243 @@ struct tiempos_ejec {
     int sistema;
 };
 
+/* Tamaño maximo de un mensaje que se copia; los mayores se entregan
+   cediendo un buffer obtenido con reservar_mensaje */
+#define TAM_MSJ_PEQ 64
+
+/* Plazo de espera sin limite para enviar y recibir */
+#define ESPERA_INDEFINIDA -1
+
+/* esperar_proceso espera al primer hijo que termine */
+#define CUALQUIER_HIJO -1
+
+/* Estado de fin de un proceso abortado por una excepcion */
+#define FIN_POR_EXCEPCION -1
+
+/* Longitud maxima (con el nulo) de los argumentos de crear_proceso_args */
+#define TAM_ARGUMENTOS 128
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para las funciones enviar() y recibir().
+ *
+ */
+struct mensaje {
+    void *datos;
+    unsigned int tam;
+    int prioridad;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_imagenes().
+ *
+ */
+struct estad_imagenes {
+    int aciertos;
+    int fallos;
+    int expulsiones;
+    int residentes;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_pilas().
+ *
+ */
+struct estad_pilas {
+    int aciertos;
+    int fallos;
+    int libres;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_tr().
+ *
+ */
+struct estad_tr {
+    int activaciones;	/* trabajos completados o perdidos del proceso */
+    int fallos;			/* trabajos que no terminaron en plazo */
+    int utilizacion;	/* utilizacion reservada en el sistema (milesimas) */
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_cuota().
+ *
+ */
+struct estad_cuota {
+    unsigned int cuota;				/* ticks por periodo (0 sin limite) */
+    unsigned int periodo;			/* ticks de cada periodo */
+    unsigned int consumo_total;		/* ticks consumidos desde que se fijo la cuota */
+    int estrangulamientos;			/* veces que ha agotado la cuota */
+    unsigned int ticks_estrangulado;	/* ticks que ha pasado esperando el siguiente periodo */
+};
+
+/*
+ *
+ * Definición de los tipos que corresponden con el anillo de llamadas que
+ * registra crear_anillo(). Las peticiones se encolan con las funciones
+ * anillo_* y se ejecutan todas con una sola llamada a entrar_anillo().
+ *
+ */
+#define TAM_ANILLO_LLAMSIS 64
+#define ARGS_ANILLO_LLAMSIS 4
+
+struct peticion_llamsis {
+    int servicio;
+    long args[ARGS_ANILLO_LLAMSIS];
+    long dato;				/* se copia sin cambios en el resultado */
+};
+
+struct resultado_llamsis {
+    int res;				/* lo que habria devuelto la llamada */
+    long dato;
+};
+
+struct anillo_llamsis {
+    unsigned int cab_sub;	/* siguiente peticion que ejecutara el kernel */
+    unsigned int cola_sub;	/* siguiente hueco para una peticion */
+    unsigned int cab_com;	/* siguiente resultado por recoger */
+    unsigned int cola_com;	/* siguiente hueco para un resultado */
+    struct peticion_llamsis sub[TAM_ANILLO_LLAMSIS];
+    struct resultado_llamsis com[TAM_ANILLO_LLAMSIS];
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función estadisticas_llamsis().
+ *
+ */
+#define LLAMSIS_GLOBAL -1		/* id para pedir las de todo el sistema */
+#define TAM_NOMBRE_LLAMSIS 32
+
+typedef struct {
+    unsigned int llamadas;
+    unsigned int bloqueos;		/* llamadas en las que el proceso se bloqueo */
+    unsigned int errores;		/* llamadas que devolvieron un valor negativo */
+    unsigned long long ns_total;	/* tiempo dentro de la llamada, incluido el bloqueado */
+    unsigned long long ns_sistema;	/* lo mismo sin el tiempo fuera del procesador */
+    unsigned long long ns_max;
+} contadores_llamsis;
+
+struct estad_llamsis {
+    char nombre[TAM_NOMBRE_LLAMSIS];
+    contadores_llamsis c;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la pagina de datos del kernel
+ * (de solo lectura) que devuelve datos_kernel(). La biblioteca la usa
+ * para obtener_id_pr, tiempos_proceso y tiempos_propios sin entrar en
+ * el kernel.
+ *
+ */
+struct datos_kernel {
+    unsigned int secuencia;			/* impar mientras el kernel la actualiza */
+    int id_actual;					/* proceso en ejecucion */
+    unsigned long long ticks;		/* ticks desde el arranque */
+    unsigned long long tick_ns;		/* instante del ultimo tick (obtener_tiempo_ns) */
+    unsigned long long usuario;		/* ticks en modo usuario de todo el sistema */
+    unsigned long long sistema;		/* ticks en modo sistema de todo el sistema */
+    unsigned long long proc_usuario;	/* ticks en modo usuario del proceso en ejecucion */
+    unsigned long long proc_sistema;	/* ticks en modo sistema del proceso en ejecucion */
+    void *funcion_hilo;				/* funcion y argumento del proceso en ejecucion */
+    void *arg_hilo;					/* si es un hilo (para la lanzadera) */
+    unsigned long long arranque_ns;	/* origen de obtener_tiempo_ns en el reloj monotono */
+};
+
+
+/*
+ *
+ * Definición de los tipos que corresponden con la entrada para la función
+ * foto_procesos() (los estados de un proceso vienen de estados.h).
+ *
+ */
+#define TAM_NOMBRE_FOTO 32
+#define SIN_ESPERA -1			/* no esta bloqueado en un mutex, pipe o cola */
+
+struct info_proc {
+    int id;
+    int padre;
+    int estado;
+    char prog[TAM_NOMBRE_FOTO];		/* vacio si su imagen no esta en la cache */
+    int espera;						/* mutex, pipe o cola en que esta bloqueado (o SIN_ESPERA) */
+    char nombre_espera[TAM_NOMBRE_FOTO];
+    int dueno_espera;				/* proceso que tiene el mutex que espera (-1 si no aplica) */
+    unsigned int t_wake;			/* tick en que despierta si esta DORMIDO */
+    unsigned long long ticks_usuario;
+    unsigned long long ticks_sistema;
+    int nice;
+    int mutex_ids[NUM_MUT_PROC];	/* mutex abiertos (-1 si no) */
+};
+
+struct foto_sistema {
+    unsigned long long ticks;		/* ticks desde el arranque al tomarla */
+    int n_procs;					/* procesos existentes, incluidos zombis */
+    int n_listos;					/* listos sin contar el que esta en ejecucion */
+    int n_dormidos;
+    int n_bloqueados;				/* en un mutex, terminal, pipe, cola o esperando a un hijo */
+    int n_estrangulados;
+    int n_zombis;
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función
+ * estadisticas_sistema() (indexada por los vectores de const.h).
+ *
+ */
+
+struct estad_sistema {
+    unsigned long long interrupciones[NVECTORES];	/* tratadas por cada vector */
+    unsigned long long cambios_voluntarios;		/* el proceso se bloquea */
+    unsigned long long cambios_involuntarios;	/* el proceso es expulsado */
+    unsigned long long cambios_fin;				/* el proceso termina */
+    unsigned long long ticks;
+    unsigned long long ticks_ociosos;			/* sin procesos listos */
+    int ejecutables;					/* listos, incluido el que esta en ejecucion */
+    unsigned int carga[3];				/* media de ejecutables en 1, 5 y 15 s (milesimas) */
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función
+ * leer_perfil(), y de los tamaños del perfilador.
+ *
+ */
+#define TAM_PERFIL 4096			/* muestras que guarda el perfil de un proceso */
+#define TAM_SIMBOLO 128			/* longitud (con el nulo) de "programa:funcion" */
+
+struct info_perfil {
+    int activo;						/* se estan tomando muestras */
+    int terminado;					/* el proceso ya ha terminado (zombi) */
+    unsigned int muestras;			/* PCs de usuario guardados */
+    unsigned int perdidas;			/* ticks de usuario sin sitio o sin PC en su imagen */
+    unsigned int sistema;			/* ticks en modo sistema mientras se perfilaba */
+};
+
+/*
+ *
+ * Definición del tipo que corresponde con la entrada para la función
+ * estadisticas_secciones(): las secciones con interrupciones inhibidas
+ * que abre cada punto del kernel que sube el nivel de interrupcion.
+ *
+ */
+#define CUBETAS_SECCION 16
+#define TAM_NOMBRE_SECCION 32
+
+struct estad_seccion {
+    char funcion[TAM_NOMBRE_SECCION];
+    int linea;
+    int nivel;						/* nivel al que sube */
+    unsigned int veces;				/* secciones cerradas */
+    unsigned long long ns_total;
+    unsigned long long ns_max;
+    unsigned int histograma[CUBETAS_SECCION];	/* cubeta 0: < 1 us; i: [2^(i-1), 2^i) us */
+};
 
 /* Funcion de biblioteca */
 int escribirf(const char *formato, ...);
@@ -53,6 +301,77 @@ int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
 int leer_caracter();
+int crear_pipe(char *nombre, unsigned int tam, int modo);
+int abrir_pipe(char *nombre, int modo);
+int leer_pipe(unsigned int pipedesc, char *buf, unsigned int tam);
+int escribir_pipe(unsigned int pipedesc, char *buf, unsigned int tam);
+int cerrar_pipe(unsigned int pipedesc);
+int crear_cola(char *nombre, unsigned int max_mensajes);
+int abrir_cola(char *nombre);
+int enviar(unsigned int colaid, struct mensaje *msj, int timeout);
+int recibir(unsigned int colaid, struct mensaje *msj, int timeout);
+int cerrar_cola(unsigned int colaid);
+int reservar_mensaje(unsigned int tam, void **datos);
+int liberar_mensaje(void *datos);
+int crear_memoria_compartida(char *nombre, unsigned int tam, void **dir);
+int abrir_memoria_compartida(char *nombre, void **dir);
+int cerrar_memoria_compartida(unsigned int shmid);
+int estadisticas_imagenes(struct estad_imagenes *est);
+int vaciar_cache_imagenes();
+int estadisticas_pilas(struct estad_pilas *est);
+int crear_procesos(char *prog, unsigned int n, int *ids);
+int esperar_proceso(int id, int *estado);
+int salir(int estado);
+int crear_hilo(int (*funcion)(void *), void *arg);
+int esperar_hilo(int id, int *estado);
+int ceder_procesador();
+int dormir_ticks(unsigned int ticks);
+int dormir_hasta(unsigned int t_abs);
+int crear_temporizador_periodico(unsigned int periodo, unsigned int plazo, unsigned int coste);
+int esperar_periodo();
+int estadisticas_tr(struct estad_tr *est);
+int fijar_nice(int nice);
+int fijar_cuota(int id, unsigned int ticks_por_periodo, unsigned int periodo);
+int estadisticas_cuota(int id, struct estad_cuota *est);
+int crear_anillo(struct anillo_llamsis *anillo);
+int entrar_anillo();
+int estadisticas_llamsis(int id, struct estad_llamsis *tabla, unsigned int n);
+int datos_kernel(const struct datos_kernel **dir);
+int tiempos_propios(struct tiempos_ejec *t_ejec);
+unsigned long long obtener_tiempo_ns();
+unsigned long long obtener_hora();
+int crear_proceso_args(char *prog, char *args);
+int argumentos(char *buf, unsigned int tam);
+int foto_procesos(struct foto_sistema *foto, struct info_proc *procs, unsigned int n);
+int estadisticas_sistema(struct estad_sistema *est);
+int iniciar_perfil(int id);
+int parar_perfil(int id);
+int leer_perfil(int id, struct info_perfil *info, void **muestras, unsigned int max);
+int simbolizar(void *dir, char *nombre, unsigned int tam);
+int estadisticas_secciones(struct estad_seccion *tabla, unsigned int n);
+
+/* Biblioteca de hilos verdes (no hacen llamadas al sistema). Las
+   instancias de un programa comparten la tabla de tareas: solo la usa
+   un proceso a la vez */
+int crear_verde(void (*funcion)(void *), void *arg);
+void ceder_verde();
+void terminar_verde();
+int verde_en_ejecucion();
+int ejecutar_verdes();
+
+/* Biblioteca del anillo de llamadas (encolan sin entrar en el kernel;
+   devuelven -1 si el anillo esta lleno) */
+int anillo_escribir(struct anillo_llamsis *a, char *texto, unsigned int longi, long dato);
+int anillo_obtener_id_pr(struct anillo_llamsis *a, long dato);
+int anillo_lock(struct anillo_llamsis *a, unsigned int mutexid, long dato);
+int anillo_unlock(struct anillo_llamsis *a, unsigned int mutexid, long dato);
+int anillo_leer_caracter(struct anillo_llamsis *a, long dato);
+int anillo_resultado(struct anillo_llamsis *a, struct resultado_llamsis *r);
+
+/* Biblioteca de argumentos (no hacen llamadas al sistema) */
+int argumento_entero(const char *args, const char *nombre, int defecto);
+int poner_argumento(char *args, unsigned int tam, const char *nombre, int valor);
+int argumento_cadena(const char *args, const char *nombre, char *valor, unsigned int tam);
 
 #endif /* SERVICIOS_H */
 
@@ -24,6 +24,7 @@
 #include "servicios.h"
 
 int main(){
+	int id, estado;
 
 	printf("init: comienza\n");
 
@@ -82,10 +83,128 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE */
 		printf("Error creando prueba_RR2\n");
 */
 
+/* PRUEBA DE RENDIMIENTO DE PIPES 
+	if (crear_proceso("prueba_pipe")<0)
+		printf("Error creando prueba_pipe\n");
+*/
+
+/* PRUEBA DE COLAS DE MENSAJES 
+	if (crear_proceso("prueba_cola")<0)
+		printf("Error creando prueba_cola\n");
+*/
+
+/* PRUEBA DE MEMORIA COMPARTIDA 
+	if (crear_proceso("prueba_shm")<0)
+		printf("Error creando prueba_shm\n");
+*/
+
+/* PRUEBA DE LA CACHE DE IMAGENES 
+	if (crear_proceso("prueba_spawn")<0)
+		printf("Error creando prueba_spawn\n");
+*/
+
+/* PRUEBA DE CARGA DE LA TABLA DE PROCESOS 
+	if (crear_proceso("prueba_procs")<0)
+		printf("Error creando prueba_procs\n");
+*/
+
+/* PRUEBA DE CREACION DE PROCESOS EN TANDAS 
+	if (crear_proceso("prueba_tanda")<0)
+		printf("Error creando prueba_tanda\n");
+*/
+
+/* PRUEBA DE ESPERA POR HIJOS 
+	if (crear_proceso("prueba_esperar")<0)
+		printf("Error creando prueba_esperar\n");
+*/
+
+/* PRUEBA DE HILOS 
+	if (crear_proceso("prueba_hilos")<0)
+		printf("Error creando prueba_hilos\n");
+*/
+
+/* PRUEBA DE CESION DEL PROCESADOR E HILOS VERDES 
+	if (crear_proceso("prueba_ceder")<0)
+		printf("Error creando prueba_ceder\n");
+*/
+
+/* PRUEBA DE BUCLE PERIODICO CON DORMIR_HASTA Y DORMIR_TICKS 
+	if (crear_proceso("prueba_periodo")<0)
+		printf("Error creando prueba_periodo\n");
+*/
+
+/* PRUEBA DE PLANIFICACION EDF DE PROCESOS PERIODICOS 
+	if (crear_proceso("prueba_tr")<0)
+		printf("Error creando prueba_tr\n");
+*/
+
+/* PRUEBA DE REPARTO DEL PROCESADOR (CFS: PLANIFICADOR=CFS boot/boot minikernel/kernel) 
+	if (crear_proceso("prueba_cfs")<0)
+		printf("Error creando prueba_cfs\n");
+*/
+
+/* PRUEBA DE CUOTAS DE PROCESADOR 
+	if (crear_proceso("prueba_cuota")<0)
+		printf("Error creando prueba_cuota\n");
+*/
+
+/* PRUEBA DEL ANILLO DE LLAMADAS 
+	if (crear_proceso("prueba_anillo")<0)
+		printf("Error creando prueba_anillo\n");
+*/
+
+/* SERVICIOS QUE MAS TIEMPO DE SISTEMA CONSUMEN 
+	if (crear_proceso("syscall_top")<0)
+		printf("Error creando syscall_top\n");
+*/
+
+/* PAGINA DE DATOS DEL KERNEL 
+	if (crear_proceso("prueba_datos")<0)
+		printf("Error creando prueba_datos\n");
+*/
+
+/* RELOJES DE ALTA RESOLUCION Y DE PARED 
+	if (crear_proceso("prueba_reloj")<0)
+		printf("Error creando prueba_reloj\n");
+*/
+
+/* PROGRAMAS DE MEDIDA (el del terminal espera caracteres hasta un '.') 
+	if (crear_proceso("bench/bench")<0)
+		printf("Error creando bench/bench\n");
+*/
+
+/* GENERADOR DE CARGA (mezcla configurable por argumentos, ver bench/carga.c) 
+	if (crear_proceso_args("bench/carga", "cpu=2 io=4 uso_io=10 cerrojo=3 duracion=500")<0)
+		printf("Error creando bench/carga\n");
+*/
+
+/* ESTADO DEL SISTEMA (mejor junto con otros procesos, p.ej. bench/carga) 
+	if (crear_proceso("top")<0)
+		printf("Error creando top\n");
+*/
+
+/* CONTADORES GLOBALES Y MEDIAS DE CARGA (mejor junto con otros procesos) 
+	if (crear_proceso("vmstat")<0)
+		printf("Error creando vmstat\n");
+*/
+
+/* PERFILADOR (caliente reparte su trabajo 3 a 1 entre dos funciones) 
+	if (crear_proceso_args("perfil", "prog=caliente duracion=1000")<0)
+		printf("Error creando perfil\n");
+*/
+
+/* SECCIONES CRITICAS DEL KERNEL (mejor junto con otros procesos, p.ej. bench/carga) 
+	if (crear_proceso_args("secciones", "espera=500")<0)
+		printf("Error creando secciones\n");
+*/
+
 /* PRUEBA DEL TERMINAL */
 	if (crear_proceso("prueba_term")<0)
 		printf("Error creando prueba_term\n");
 
+	/* Espera a sus hijos y a los que adopta al terminar sus padres */
+	while ((id=esperar_proceso(CUALQUIER_HIJO, &estado))>=0)
+		printf("init: termina el proceso %d con estado %d\n", id, estado);
 
 	printf("init: termina\n");
 	return 0; 
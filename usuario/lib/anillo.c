@@ -0,0 +1,73 @@
+/*
+ *  usuario/lib/anillo.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene la biblioteca del anillo de llamadas: funciones
+ * que encolan peticiones de servicio en el anillo registrado con
+ * crear_anillo y recogen sus resultados. Ninguna entra en el kernel;
+ * las peticiones se ejecutan al llamar a entrar_anillo.
+ *
+ */
+
+#include "llamsis.h"
+#include "servicios.h"
+
+/*
+ * Encola una peticion. Devuelve -1 si no cabe.
+ */
+static int encolar_peticion(struct anillo_llamsis *a, int servicio,
+	long arg1, long arg2, long arg3, long dato){
+	struct peticion_llamsis *p;
+
+	if (a->cola_sub - a->cab_sub >= TAM_ANILLO_LLAMSIS)
+		return -1;
+
+	p = &a->sub[a->cola_sub % TAM_ANILLO_LLAMSIS];
+	p->servicio = servicio;
+	p->args[0] = arg1;
+	p->args[1] = arg2;
+	p->args[2] = arg3;
+	p->args[3] = 0;
+	p->dato = dato;
+	a->cola_sub++;
+	return 0;
+}
+
+int anillo_escribir(struct anillo_llamsis *a, char *texto, unsigned int longi, long dato){
+	return encolar_peticion(a, ESCRIBIR, (long)texto, (long)longi, 0, dato);
+}
+
+int anillo_obtener_id_pr(struct anillo_llamsis *a, long dato){
+	return encolar_peticion(a, OBTENER_ID_PR, 0, 0, 0, dato);
+}
+
+int anillo_lock(struct anillo_llamsis *a, unsigned int mutexid, long dato){
+	return encolar_peticion(a, LOCK, (long)mutexid, 0, 0, dato);
+}
+
+int anillo_unlock(struct anillo_llamsis *a, unsigned int mutexid, long dato){
+	return encolar_peticion(a, UNLOCK, (long)mutexid, 0, 0, dato);
+}
+
+int anillo_leer_caracter(struct anillo_llamsis *a, long dato){
+	return encolar_peticion(a, LEER_CARACTER, 0, 0, 0, dato);
+}
+
+/*
+ * Recoge el siguiente resultado. Devuelve -1 si no hay ninguno.
+ */
+int anillo_resultado(struct anillo_llamsis *a, struct resultado_llamsis *r){
+	if (a->cab_com == a->cola_com)
+		return -1;
+
+	*r = a->com[a->cab_com % TAM_ANILLO_LLAMSIS];
+	a->cab_com++;
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ *  usuario/lib/argumentos.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene funciones de biblioteca para construir e
+ * interpretar la cadena de argumentos de un proceso (ver
+ * crear_proceso_args), formada por parejas nombre=valor separadas por
+ * espacios.
+ *
+ */
+
+#include "servicios.h"
+
+/*
+ * Devuelve el valor del argumento nombre (lo que sigue al '='), o 0
+ * si no aparece.
+ */
+static const char *buscar_argumento(const char *args, const char *nombre){
+	const char *p, *n;
+
+	for (p = args; *p; ) {
+		/* compara el nombre del argumento que empieza en p */
+		for (n = nombre; *n && *p == *n; p++, n++);
+		if (*n == '\0' && *p == '=')
+			return p+1;
+
+		/* salta al siguiente argumento */
+		while (*p && *p != ' ')
+			p++;
+		while (*p == ' ')
+			p++;
+	}
+	return 0;
+}
+
+/*
+ * Devuelve el valor entero (no negativo) del argumento nombre, o
+ * defecto si no aparece o no es un numero.
+ */
+int argumento_entero(const char *args, const char *nombre, int defecto){
+	const char *p;
+	int valor;
+
+	p = buscar_argumento(args, nombre);
+	if (p == 0 || *p < '0' || *p > '9')
+		return defecto;
+	for (valor = 0; *p >= '0' && *p <= '9'; p++)
+		valor = valor*10 + (*p - '0');
+	return valor;
+}
+
+/*
+ * Copia en valor, de tam bytes, el valor del argumento nombre (hasta el
+ * siguiente espacio). Devuelve su longitud o -1 si no aparece, dejando
+ * valor como estaba.
+ */
+int argumento_cadena(const char *args, const char *nombre, char *valor, unsigned int tam){
+	const char *p;
+	unsigned int i;
+
+	if ((p = buscar_argumento(args, nombre)) == 0 || tam == 0)
+		return -1;
+	for (i = 0; p[i] && p[i] != ' ' && i < tam-1; i++)
+		valor[i] = p[i];
+	valor[i] = '\0';
+	return i;
+}
+
+/*
+ * Añade nombre=valor (valor no negativo) al final de la cadena args,
+ * de tam bytes. Devuelve -1 si no cabe, dejando args como estaba.
+ */
+int poner_argumento(char *args, unsigned int tam, const char *nombre, int valor){
+	char cifras[12];
+	unsigned int longi, i, n = 0;
+
+	for (longi = 0; args[longi]; longi++);
+	do {
+		cifras[n++] = '0' + valor % 10;
+		valor /= 10;
+	} while (valor > 0 && n < sizeof(cifras));
+
+	i = longi;
+	if (i > 0 && i < tam)
+		args[i++] = ' ';
+	for ( ; *nombre && i < tam; nombre++)
+		args[i++] = *nombre;
+	if (i < tam)
+		args[i++] = '=';
+	while (n > 0 && i < tam)
+		args[i++] = cifras[--n];
+	if (i >= tam) {
+		args[longi] = '\0';
+		return -1;
+	}
+	args[i] = '\0';
+	return 0;
+}
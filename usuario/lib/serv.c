@@ -16,6 +16,7 @@
  *
  */
 
+#include <time.h> /* Para emplear la funcion clock_gettime */
 #include "llamsis.h"
 #include "servicios.h"
 
@@ -26,6 +27,17 @@
 
 int llamsis(int llamada, int nargs, ... /* args */);
 
+/* Pagina de datos del kernel, que se pide la primera vez que hace falta.
+   Las llamadas que solo consultan datos que hay en ella no entran en el
+   kernel */
+static const struct datos_kernel *datos = 0;
+
+static volatile const struct datos_kernel *pagina_datos(){
+	if (datos == 0)
+		llamsis(DATOS_KERNEL, 1, &datos);
+	return datos;
+}
+
 
 /*
  *
@@ -43,13 +55,26 @@ int escribir(char *texto, unsigned int longi){
 	return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
 }
 int obtener_id_pr(){
-   return llamsis(OBTENER_ID_PR, 0);
+   return pagina_datos()->id_actual;
 }
 int dormir(unsigned int segundos){
    return llamsis(DORMIR, 1, (long)segundos);
 }
 int tiempos_proceso(struct tiempos_ejec *t_ejec){
-   return llamsis(TIEMPOS_PROCESO, 1, t_ejec);
+   volatile const struct datos_kernel *d = pagina_datos();
+   unsigned int sec;
+   int ticks;
+
+   /* se repite si el kernel la ha cambiado mientras se leia */
+   do {
+      sec = d->secuencia;
+      ticks = d->ticks;
+      if (t_ejec) {
+         t_ejec->usuario = d->usuario;
+         t_ejec->sistema = d->sistema;
+      }
+   } while ((sec & 1) || sec != d->secuencia);
+   return ticks;
 }
 int crear_mutex(char *nombre, int tipo){
    return llamsis(CREAR_MUTEX, 2, nombre, tipo);
@@ -68,4 +93,187 @@ int cerrar_mutex(unsigned int mutexid){
 }
 int leer_caracter(){
    return llamsis(LEER_CARACTER, 0);
-}
\ No newline at end of file
+}
+int crear_pipe(char *nombre, unsigned int tam, int modo){
+   return llamsis(CREAR_PIPE, 3, nombre, tam, modo);
+}
+int abrir_pipe(char *nombre, int modo){
+   return llamsis(ABRIR_PIPE, 2, nombre, modo);
+}
+int leer_pipe(unsigned int pipedesc, char *buf, unsigned int tam){
+   return llamsis(LEER_PIPE, 3, pipedesc, buf, tam);
+}
+int escribir_pipe(unsigned int pipedesc, char *buf, unsigned int tam){
+   return llamsis(ESCRIBIR_PIPE, 3, pipedesc, buf, tam);
+}
+int cerrar_pipe(unsigned int pipedesc){
+   return llamsis(CERRAR_PIPE, 1, pipedesc);
+}
+int crear_cola(char *nombre, unsigned int max_mensajes){
+   return llamsis(CREAR_COLA, 2, nombre, max_mensajes);
+}
+int abrir_cola(char *nombre){
+   return llamsis(ABRIR_COLA, 1, nombre);
+}
+int enviar(unsigned int colaid, struct mensaje *msj, int timeout){
+   return llamsis(ENVIAR, 3, colaid, msj, timeout);
+}
+int recibir(unsigned int colaid, struct mensaje *msj, int timeout){
+   return llamsis(RECIBIR, 3, colaid, msj, timeout);
+}
+int cerrar_cola(unsigned int colaid){
+   return llamsis(CERRAR_COLA, 1, colaid);
+}
+int reservar_mensaje(unsigned int tam, void **datos){
+   return llamsis(RESERVAR_MENSAJE, 2, tam, datos);
+}
+int liberar_mensaje(void *datos){
+   return llamsis(LIBERAR_MENSAJE, 1, datos);
+}
+int crear_memoria_compartida(char *nombre, unsigned int tam, void **dir){
+   return llamsis(CREAR_MEM_COMPARTIDA, 3, nombre, tam, dir);
+}
+int abrir_memoria_compartida(char *nombre, void **dir){
+   return llamsis(ABRIR_MEM_COMPARTIDA, 2, nombre, dir);
+}
+int cerrar_memoria_compartida(unsigned int shmid){
+   return llamsis(CERRAR_MEM_COMPARTIDA, 1, shmid);
+}
+int estadisticas_imagenes(struct estad_imagenes *est){
+   return llamsis(ESTADISTICAS_IMAGENES, 1, est);
+}
+int vaciar_cache_imagenes(){
+   return llamsis(VACIAR_CACHE_IMAGENES, 0);
+}
+int estadisticas_pilas(struct estad_pilas *est){
+   return llamsis(ESTADISTICAS_PILAS, 1, est);
+}
+int crear_procesos(char *prog, unsigned int n, int *ids){
+   return llamsis(CREAR_PROCESOS, 3, prog, n, ids);
+}
+int esperar_proceso(int id, int *estado){
+   return llamsis(ESPERAR_PROCESO, 2, id, estado);
+}
+int salir(int estado){
+   return llamsis(SALIR, 1, estado);
+}
+
+/* Punto de arranque de los hilos: lee de la pagina de datos la funcion
+   y el argumento que guardo el kernel (sin entrar en el) y termina el
+   hilo con lo que devuelva */
+static void lanzadera_hilo(){
+   volatile const struct datos_kernel *d = pagina_datos();
+   int (*funcion)(void *);
+   void *arg;
+   unsigned int sec;
+
+   do {
+      sec = d->secuencia;
+      funcion = d->funcion_hilo;
+      arg = d->arg_hilo;
+   } while ((sec & 1) || sec != d->secuencia);
+   salir(funcion(arg));
+}
+int crear_hilo(int (*funcion)(void *), void *arg){
+   return llamsis(CREAR_HILO, 3, lanzadera_hilo, funcion, arg);
+}
+int esperar_hilo(int id, int *estado){
+   return llamsis(ESPERAR_PROCESO, 2, id, estado);
+}
+int ceder_procesador(){
+   return llamsis(CEDER_PROCESADOR, 0);
+}
+int dormir_ticks(unsigned int ticks){
+   return llamsis(DORMIR_TICKS, 1, (long)ticks);
+}
+int dormir_hasta(unsigned int t_abs){
+   return llamsis(DORMIR_HASTA, 1, (long)t_abs);
+}
+int crear_temporizador_periodico(unsigned int periodo, unsigned int plazo, unsigned int coste){
+   return llamsis(CREAR_TEMPORIZADOR_PERIODICO, 3, (long)periodo, (long)plazo, (long)coste);
+}
+int esperar_periodo(){
+   return llamsis(ESPERAR_PERIODO, 0);
+}
+int estadisticas_tr(struct estad_tr *est){
+   return llamsis(ESTADISTICAS_TR, 1, est);
+}
+int fijar_nice(int nice){
+   return llamsis(FIJAR_NICE, 1, (long)nice);
+}
+int fijar_cuota(int id, unsigned int ticks_por_periodo, unsigned int periodo){
+   return llamsis(FIJAR_CUOTA, 3, (long)id, (long)ticks_por_periodo, (long)periodo);
+}
+int estadisticas_cuota(int id, struct estad_cuota *est){
+   return llamsis(ESTADISTICAS_CUOTA, 2, (long)id, est);
+}
+int crear_anillo(struct anillo_llamsis *anillo){
+   return llamsis(CREAR_ANILLO, 1, anillo);
+}
+int entrar_anillo(){
+   return llamsis(ENTRAR_ANILLO, 0);
+}
+int estadisticas_llamsis(int id, struct estad_llamsis *tabla, unsigned int n){
+   return llamsis(ESTADISTICAS_LLAMSIS, 3, (long)id, tabla, (long)n);
+}
+int datos_kernel(const struct datos_kernel **dir){
+   return llamsis(DATOS_KERNEL, 1, dir);
+}
+/* Lee directamente el reloj monotono que usa el kernel y le resta el
+   arranque publicado en la pagina de datos (no cambia, asi que no hace
+   falta comprobar la secuencia). Sin pagina se lo pide al kernel */
+unsigned long long obtener_tiempo_ns(){
+   volatile const struct datos_kernel *d = pagina_datos();
+   struct timespec ts;
+   unsigned long long t;
+
+   if (d == 0 || clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+      llamsis(OBTENER_TIEMPO_NS, 1, &t);
+      return t;
+   }
+   return (unsigned long long)ts.tv_sec*1000000000ULL + ts.tv_nsec - d->arranque_ns;
+}
+unsigned long long obtener_hora(){
+   unsigned long long ms;
+
+   llamsis(OBTENER_HORA, 1, &ms);
+   return ms;
+}
+int crear_proceso_args(char *prog, char *args){
+   return llamsis(CREAR_PROCESO_ARGS, 2, prog, args);
+}
+int argumentos(char *buf, unsigned int tam){
+   return llamsis(ARGUMENTOS, 2, buf, (long)tam);
+}
+int foto_procesos(struct foto_sistema *foto, struct info_proc *procs, unsigned int n){
+   return llamsis(FOTO_PROCESOS, 3, foto, procs, (long)n);
+}
+int estadisticas_sistema(struct estad_sistema *est){
+   return llamsis(ESTADISTICAS_SISTEMA, 1, est);
+}
+int iniciar_perfil(int id){
+   return llamsis(INICIAR_PERFIL, 1, (long)id);
+}
+int parar_perfil(int id){
+   return llamsis(PARAR_PERFIL, 1, (long)id);
+}
+int leer_perfil(int id, struct info_perfil *info, void **muestras, unsigned int max){
+   return llamsis(LEER_PERFIL, 4, (long)id, info, muestras, (long)max);
+}
+int simbolizar(void *dir, char *nombre, unsigned int tam){
+   return llamsis(SIMBOLIZAR, 3, dir, nombre, (long)tam);
+}
+int estadisticas_secciones(struct estad_seccion *tabla, unsigned int n){
+   return llamsis(ESTADISTICAS_SECCIONES, 2, tabla, (long)n);
+}
+int tiempos_propios(struct tiempos_ejec *t_ejec){
+   volatile const struct datos_kernel *d = pagina_datos();
+   unsigned int sec;
+
+   do {
+      sec = d->secuencia;
+      t_ejec->usuario = d->proc_usuario;
+      t_ejec->sistema = d->proc_sistema;
+   } while ((sec & 1) || sec != d->secuencia);
+   return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ *  usuario/lib/verde.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ *
+ * Fichero que contiene la biblioteca de hilos verdes: tareas de usuario
+ * que se reparten un unico proceso del minikernel cediendose el
+ * procesador entre ellas (corrutinas). Los cambios entre tareas no
+ * entran en el kernel; si una tarea hace una llamada bloqueante se
+ * bloquea el proceso entero.
+ *
+ * Las instancias vivas de un programa comparten su imagen y, con ella,
+ * la tabla de tareas y sus pilas. Por eso las usa un solo proceso a la
+ * vez: el que crea la primera tarea, hasta que terminan todas. En los
+ * demas (incluidos los hilos del kernel del dueño) crear_verde y
+ * ejecutar_verdes fallan y ceder_verde y terminar_verde no hacen nada.
+ * Si el dueño termina sin acabar sus tareas, la tabla sigue ocupada
+ * mientras la imagen este cargada.
+ *
+ */
+
+#include "servicios.h"
+
+#define NUM_VERDES 64			/* numero maximo de tareas vivas */
+#define TAM_PILA_VERDE 16384	/* tamaño de la pila de cada tarea */
+
+#define VERDE_LIBRE 0
+#define VERDE_LISTA 1
+
+/* Descriptor de una tarea */
+typedef struct {
+	int estado;				/* VERDE_LIBRE|VERDE_LISTA */
+	void *sp;				/* puntero de pila guardado al ceder */
+	void (*funcion)(void *);
+	void *arg;
+} verde;
+
+static verde tabla_verdes[NUM_VERDES];
+static char pilas_verdes[NUM_VERDES][TAM_PILA_VERDE] __attribute__((aligned(16)));
+static void *sp_principal;		/* pila de quien llamo a ejecutar_verdes */
+static int verde_actual = -1;	/* tarea en ejecucion (-1 fuera de ejecutar_verdes) */
+static int num_verdes = 0;		/* tareas vivas */
+static int dueno_verdes = -1;	/* proceso que usa la tabla (-1 si no hay tareas) */
+
+/*
+ * Devuelve si el proceso en ejecucion es el dueño de la tabla. Lee su
+ * id de la pagina de datos, sin entrar en el kernel.
+ */
+static int es_dueno(){
+	return dueno_verdes == obtener_id_pr();
+}
+
+/*
+ * Cambio de pila: guarda los registros que conserva el llamado en la pila
+ * actual, deja su puntero en *sp_viejo y los recupera de sp_nuevo.
+ */
+void cambiar_pila_verde(void **sp_viejo, void *sp_nuevo);
+
+#if defined(__x86_64__)
+__asm__(
+	".text\n"
+	".globl cambiar_pila_verde\n"
+	".hidden cambiar_pila_verde\n"
+	".type cambiar_pila_verde,@function\n"
+	"cambiar_pila_verde:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	movq %rsp,(%rdi)\n"
+	"	movq %rsi,%rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n");
+#define REGS_GUARDADOS 6
+#elif defined(__i386__)
+__asm__(
+	".text\n"
+	".globl cambiar_pila_verde\n"
+	".hidden cambiar_pila_verde\n"
+	".type cambiar_pila_verde,@function\n"
+	"cambiar_pila_verde:\n"
+	"	movl 4(%esp),%eax\n"
+	"	movl 8(%esp),%edx\n"
+	"	pushl %ebp\n"
+	"	pushl %ebx\n"
+	"	pushl %esi\n"
+	"	pushl %edi\n"
+	"	movl %esp,(%eax)\n"
+	"	movl %edx,%esp\n"
+	"	popl %edi\n"
+	"	popl %esi\n"
+	"	popl %ebx\n"
+	"	popl %ebp\n"
+	"	ret\n");
+#define REGS_GUARDADOS 4
+#else
+#error "arquitectura no soportada por los hilos verdes"
+#endif
+
+/*
+ * Busca la siguiente tarea lista a partir de la actual (turno rotatorio).
+ * Devuelve -1 si no queda ninguna.
+ */
+static int siguiente_verde(){
+	int i, n;
+
+	for (i=1; i<=NUM_VERDES; i++) {
+		n = (verde_actual + i) % NUM_VERDES;
+		if (tabla_verdes[n].estado == VERDE_LISTA)
+			return n;
+	}
+	return -1;
+}
+
+/*
+ * Punto de arranque de todas las tareas
+ */
+static void arranque_verde(){
+	tabla_verdes[verde_actual].funcion(tabla_verdes[verde_actual].arg);
+	terminar_verde();
+}
+
+/*
+ * Crea una tarea que ejecutara funcion(arg) cuando se llame a
+ * ejecutar_verdes. Devuelve su identificador, o -1 si no caben mas o
+ * si la tabla la esta usando otro proceso.
+ */
+int crear_verde(void (*funcion)(void *), void *arg){
+	void **sp;
+	int i, n;
+
+	if (num_verdes == 0)
+		dueno_verdes = obtener_id_pr();
+	else if (!es_dueno())
+		return -1;
+
+	for (n=0; n<NUM_VERDES && tabla_verdes[n].estado != VERDE_LIBRE; n++);
+	if (n == NUM_VERDES)
+		return -1;
+
+	/* la pila inicial simula una llamada a cambiar_pila_verde desde
+	   arranque_verde, con la alineacion de una llamada a funcion */
+	sp = (void **)&pilas_verdes[n][TAM_PILA_VERDE];
+	*--sp = 0;
+	*--sp = (void *)arranque_verde;
+	for (i=0; i<REGS_GUARDADOS; i++)
+		*--sp = 0;
+
+	tabla_verdes[n].sp = sp;
+	tabla_verdes[n].funcion = funcion;
+	tabla_verdes[n].arg = arg;
+	tabla_verdes[n].estado = VERDE_LISTA;
+	num_verdes++;
+
+	return n;
+}
+
+/*
+ * Cede el procesador a la siguiente tarea lista. Si no hay otra,
+ * sigue la actual.
+ */
+void ceder_verde(){
+	int ant = verde_actual, sig;
+
+	if (ant < 0 || !es_dueno())
+		return;	/* fuera de ejecutar_verdes */
+
+	sig = siguiente_verde();
+	if (sig == ant)
+		return;
+
+	verde_actual = sig;
+	cambiar_pila_verde(&tabla_verdes[ant].sp, tabla_verdes[sig].sp);
+}
+
+/*
+ * Termina la tarea actual y pasa a la siguiente; con la ultima se
+ * vuelve a ejecutar_verdes. Volver de la funcion de la tarea equivale
+ * a llamarla.
+ */
+void terminar_verde(){
+	int ant = verde_actual, sig;
+	void *sp_basura;
+
+	if (ant < 0 || !es_dueno())
+		return;	/* fuera de ejecutar_verdes */
+
+	tabla_verdes[ant].estado = VERDE_LIBRE;
+	num_verdes--;
+
+	sig = siguiente_verde();
+	if (sig < 0) {
+		verde_actual = -1;
+		dueno_verdes = -1;
+		cambiar_pila_verde(&sp_basura, sp_principal);
+	}
+	verde_actual = sig;
+	cambiar_pila_verde(&sp_basura, tabla_verdes[sig].sp);
+}
+
+/*
+ * Devuelve el identificador de la tarea en ejecucion (-1 si no hay).
+ */
+int verde_en_ejecucion(){
+	return es_dueno() ? verde_actual : -1;
+}
+
+/*
+ * Ejecuta las tareas creadas hasta que terminen todas (las tareas
+ * pueden crear otras). Devuelve -1 si se llama desde una tarea o si la
+ * tabla la esta usando otro proceso.
+ */
+int ejecutar_verdes(){
+	if (num_verdes == 0)
+		return 0;
+
+	if (verde_actual >= 0 || !es_dueno())
+		return -1;
+
+	verde_actual = siguiente_verde();
+	cambiar_pila_verde(&sp_principal, tabla_verdes[verde_actual].sp);
+	return 0;
+}
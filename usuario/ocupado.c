@@ -0,0 +1,31 @@
+/*
+ * usuario/ocupado.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que consume procesador sin bloquearse hasta que
+ * su creador activa la bandera de la region compartida "fin".
+ */
+
+#include "servicios.h"
+
+int main(){
+	volatile int *fin;
+	int id, i;
+
+	if ((id=abrir_memoria_compartida("fin", (void **)&fin))<0) {
+		printf("ocupado: error abriendo la region fin\n");
+		return 0;
+	}
+
+	while (!*fin)
+		for (i=0; i<10000; i++);
+
+	cerrar_memoria_compartida(id);
+	return 0;
+}
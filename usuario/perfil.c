@@ -0,0 +1,148 @@
+/*
+ * usuario/perfil.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que perfila otro proceso: toma muestras de su PC
+ * de usuario en cada tick (iniciar_perfil), las simboliza contra las
+ * imagenes cargadas y lista las MAX_LINEAS funciones con mas muestras,
+ * con el desplazamiento mas frecuente dentro de cada una. Se configura
+ * con los argumentos de crear_proceso_args:
+ *	prog=nombre	programa que se lanza y se perfila (caliente)
+ *	id=n		perfila el proceso n, ya existente, en vez de lanzar prog
+ *	duracion=n	ticks maximos de perfil (1000)
+ */
+
+#include "servicios.h"
+
+#define MAX_FUNCIONES 64
+#define MAX_LINEAS 10
+#define PASO 10			/* ticks entre consultas del perfil */
+
+struct funcion {
+	char nombre[TAM_SIMBOLO];
+	int muestras;
+	int desp_max;		/* desplazamiento con mas muestras */
+	int muestras_max;
+};
+
+static void *muestras[TAM_PERFIL];
+static struct funcion funciones[MAX_FUNCIONES];
+static int n_funciones=0;
+
+/* Ordena los PCs para que las muestras iguales queden juntas (Shell) */
+static void ordenar(void **v, int n){
+	void *aux;
+	int salto, i, j;
+
+	for (salto=n/2; salto>0; salto/=2)
+		for (i=salto; i<n; i++)
+			for (j=i; j>=salto && v[j-salto]>v[j]; j-=salto) {
+				aux=v[j];
+				v[j]=v[j-salto];
+				v[j-salto]=aux;
+			}
+}
+
+static int iguales(const char *a, const char *b){
+	while (*a && *a==*b) {
+		a++;
+		b++;
+	}
+	return *a==*b;
+}
+
+/* Suma n muestras del PC dir a la funcion que lo contiene */
+static void acumular(void *dir, int n){
+	char nombre[TAM_SIMBOLO];
+	int desp, i, k;
+
+	if ((desp=simbolizar(dir, nombre, TAM_SIMBOLO))<0) {
+		nombre[0]='?';
+		nombre[1]='\0';
+		desp=0;
+	}
+
+	for (i=0; i<n_funciones && !iguales(funciones[i].nombre, nombre); i++);
+	if (i==n_funciones) {
+		if (n_funciones==MAX_FUNCIONES)
+			return;
+		for (k=0; nombre[k]; k++)
+			funciones[i].nombre[k]=nombre[k];
+		funciones[i].nombre[k]='\0';
+		funciones[i].muestras=funciones[i].muestras_max=0;
+		n_funciones++;
+	}
+
+	funciones[i].muestras+=n;
+	if (n>funciones[i].muestras_max) {
+		funciones[i].muestras_max=n;
+		funciones[i].desp_max=desp;
+	}
+}
+
+int main(){
+	char args[TAM_ARGUMENTOS], prog[TAM_ARGUMENTOS]="caliente";
+	struct info_perfil info;
+	struct funcion aux;
+	int id, lanzado, duracion, t, n, i, j;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	argumento_cadena(args, "prog", prog, TAM_ARGUMENTOS);
+	duracion=argumento_entero(args, "duracion", 1000);
+
+	// Lanzado por el perfilador no ejecuta hasta que este se bloquee
+	lanzado=((id=argumento_entero(args, "id", -1))<0);
+	if (lanzado && (id=crear_proceso(prog))<0) {
+		printf("perfil: error creando %s\n", prog);
+		return 0;
+	}
+	if (iniciar_perfil(id)<0) {
+		printf("perfil: no se puede perfilar el proceso %d\n", id);
+		return 0;
+	}
+
+	for (t=0; t<duracion; t+=PASO) {
+		dormir_ticks(PASO);
+		if (leer_perfil(id, &info, 0, 0)<0 || info.terminado)
+			break;
+	}
+	parar_perfil(id);
+
+	if ((n=leer_perfil(id, &info, muestras, TAM_PERFIL))<0) {
+		printf("perfil: el proceso %d ya no existe\n", id);
+		return 0;
+	}
+	printf("perfil: proceso %d: %d muestras de usuario, %d perdidas, %d ticks en modo sistema\n",
+		id, n, info.perdidas, info.sistema);
+
+	// Se simboliza cada PC distinto una sola vez
+	ordenar(muestras, n);
+	for (i=0; i<n; i=j) {
+		for (j=i+1; j<n && muestras[j]==muestras[i]; j++);
+		acumular(muestras[i], j-i);
+	}
+
+	// Pocas funciones: ordenacion por insercion por muestras
+	for (i=1; i<n_funciones; i++)
+		for (j=i; j>0 && funciones[j].muestras>funciones[j-1].muestras; j--) {
+			aux=funciones[j];
+			funciones[j]=funciones[j-1];
+			funciones[j-1]=aux;
+		}
+
+	printf("%8s %4s  %-40s %s\n", "muestras", "%", "funcion", "pc mas frecuente");
+	for (i=0; i<n_funciones && i<MAX_LINEAS; i++)
+		printf("%8d %4d  %-40s +0x%x (%d)\n", funciones[i].muestras,
+			funciones[i].muestras*100/n, funciones[i].nombre,
+			funciones[i].desp_max, funciones[i].muestras_max);
+
+	if (lanzado)
+		esperar_proceso(id, 0);
+	return 0;
+}
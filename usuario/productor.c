@@ -0,0 +1,48 @@
+/*
+ * usuario/productor.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que escribe en el pipe heredado en el descriptor 0
+ * hasta que ningun otro proceso lo tiene abierto. Con los argumentos
+ * de crear_proceso_args:
+ *	pipe=nombre	abre como extremo de escritura el pipe con ese nombre
+ *	bytes=n		termina tras escribir n bytes (sin limite por defecto)
+ */
+
+#include "servicios.h"
+
+#define TAM_ESCRITURA 1024	/* bytes escritos en cada llamada */
+
+int main(){
+	char args[TAM_ARGUMENTOS], nombre[TAM_ARGUMENTOS];
+	int i, id, desc=0, total=0, n, max;
+	char buf[TAM_ESCRITURA];
+
+	id=obtener_id_pr();
+	for (i=0; i<TAM_ESCRITURA; i++)
+		buf[i]='a' + i%26;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	max=argumento_entero(args, "bytes", -1);
+	if (argumento_cadena(args, "pipe", nombre, TAM_ARGUMENTOS)>0 &&
+		(desc=abrir_pipe(nombre, PIPE_SOLO_ESCRITURA))<0) {
+		printf("productor (%d): error abriendo el pipe %s\n", id, nombre);
+		return 0;
+	}
+
+	while (max<0 || total<max) {
+		n=(max<0 || max-total>TAM_ESCRITURA) ? TAM_ESCRITURA : max-total;
+		if ((n=escribir_pipe(desc, buf, n))<=0)
+			break;
+		total+=n;
+	}
+
+	printf("productor (%d): termina tras escribir %d bytes\n", id, total);
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * usuario/prueba_anillo.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que compara las llamadas al sistema por tick que
+ * se consiguen haciendo una llamada por servicio y encolandolos en el
+ * anillo de llamadas en tandas de distinto tamaño, con un servicio
+ * trivial (obtener_id_pr) y con parejas lock/unlock. Comprueba tambien
+ * que las peticiones se ejecutan en orden y con sus resultados.
+ */
+
+#include "servicios.h"
+
+#define NUM_LLAMADAS 1000000
+
+static struct anillo_llamsis anillo;
+
+/* Llamadas por tick de n llamadas hechas en t ticks */
+static int por_tick(int n, int t){
+	return n/(t>0 ? t : 1);
+}
+
+/* Ejecuta las peticiones encoladas y comprueba sus resultados */
+static int entrar_y_recoger(int esperado){
+	struct resultado_llamsis r;
+	int errores=0;
+
+	entrar_anillo();
+	while (anillo_resultado(&anillo, &r)==0)
+		if (r.res!=esperado)
+			errores++;
+	return errores;
+}
+
+static void con_anillo_id(int tanda, int id){
+	int t0, i, j, errores=0;
+
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LLAMADAS; i+=tanda) {
+		for (j=0; j<tanda; j++)
+			anillo_obtener_id_pr(&anillo, i+j);
+		errores+=entrar_y_recoger(id);
+	}
+	printf("prueba_anillo: obtener_id_pr en tandas de %d: %d llamadas por tick (%d errores)\n",
+		tanda, por_tick(NUM_LLAMADAS, tiempos_proceso(0)-t0), errores);
+}
+
+int main(){
+	struct resultado_llamsis r;
+	char *textos[3]={"prueba_anillo: primera\n", "prueba_anillo: segunda\n", "prueba_anillo: tercera\n"};
+	int id, mut, t0, i, j, errores;
+
+	printf("prueba_anillo: comienza\n");
+
+	if (entrar_anillo()>=0)
+		printf("prueba_anillo: ERROR entrar_anillo sin anillo no falla\n");
+	crear_anillo(&anillo);
+	id=obtener_id_pr();
+
+	// Orden y resultados de una tanda mixta
+	anillo_lock(&anillo, 12345, 0);
+	for (i=0; i<3; i++)
+		anillo_escribir(&anillo, textos[i], 23, i+1);
+	anillo_obtener_id_pr(&anillo, 4);
+	printf("prueba_anillo: %d peticiones ejecutadas\n", entrar_anillo());
+	for (i=0; anillo_resultado(&anillo, &r)==0; i++)
+		printf("prueba_anillo: resultado %d: dato %ld res %d\n", i, r.dato, r.res);
+	for (i=0; i<TAM_ANILLO_LLAMSIS+1; i++)
+		if (anillo_obtener_id_pr(&anillo, 0)<0)
+			break;
+	printf("prueba_anillo: caben %d peticiones\n", i);
+	entrar_y_recoger(id);
+
+	// Servicio trivial
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LLAMADAS; i++)
+		obtener_id_pr();
+	printf("prueba_anillo: obtener_id_pr directa: %d llamadas por tick\n",
+		por_tick(NUM_LLAMADAS, tiempos_proceso(0)-t0));
+	con_anillo_id(1, id);
+	con_anillo_id(8, id);
+	con_anillo_id(TAM_ANILLO_LLAMSIS, id);
+
+	// Parejas lock/unlock
+	mut=crear_mutex("anillo", NO_RECURSIVO);
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LLAMADAS; i+=2) {
+		lock(mut);
+		unlock(mut);
+	}
+	printf("prueba_anillo: lock/unlock directas: %d llamadas por tick\n",
+		por_tick(NUM_LLAMADAS, tiempos_proceso(0)-t0));
+	errores=0;
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LLAMADAS; i+=TAM_ANILLO_LLAMSIS) {
+		for (j=0; j<TAM_ANILLO_LLAMSIS; j+=2) {
+			anillo_lock(&anillo, mut, 0);
+			anillo_unlock(&anillo, mut, 0);
+		}
+		errores+=entrar_y_recoger(0);
+	}
+	printf("prueba_anillo: lock/unlock en tandas de %d: %d llamadas por tick (%d errores)\n",
+		TAM_ANILLO_LLAMSIS, por_tick(NUM_LLAMADAS, tiempos_proceso(0)-t0), errores);
+	cerrar_mutex(mut);
+
+	printf("prueba_anillo: termina\n");
+	return 0;
+}
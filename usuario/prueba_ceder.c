@@ -0,0 +1,82 @@
+/*
+ * usuario/prueba_ceder.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la cesion del procesador: entre
+ * procesos con ceder_procesador y entre hilos verdes dentro de este
+ * proceso con ceder_verde. Las tareas verdes comprueban que se turnan
+ * en orden rotatorio. Como las instancias de un programa comparten la
+ * tabla de tareas verdes, comprueba tambien que otro proceso de la misma
+ * imagen (un hilo) no puede usarla mientras este tiene tareas.
+ */
+
+#include "servicios.h"
+
+#define TOT_CESIONES 10000	/* cesiones de cada proceso (igual que cedente) */
+#define NUM_TAREAS 16		/* tareas verdes */
+#define TOT_CAMBIOS 100000	/* cesiones de cada tarea verde */
+
+static int turno = 0;		/* tarea verde a la que le toca */
+static int fuera_de_turno = 0;
+
+static void tarea(void *arg){
+	int i, n = (long)arg;
+
+	for (i=0; i<TOT_CAMBIOS; i++) {
+		if (turno != n)
+			fuera_de_turno++;
+		turno = (n + 1) % NUM_TAREAS;
+		ceder_verde();
+	}
+}
+
+/* Hilo del kernel que intenta usar la tabla de tareas verdes ajena */
+static int intruso(void *arg){
+	return crear_verde(tarea, 0);
+}
+
+int main(){
+	unsigned long long t0, t;
+	int i, id;
+
+	printf("prueba_ceder: comienza\n");
+
+	/* Sin nadie mas listo ceder no cambia de proceso */
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_CESIONES; i++)
+		ceder_procesador();
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_ceder: %d cesiones sin otro proceso en %llu us (%llu ns por cesion)\n",
+		TOT_CESIONES, t/1000, t/TOT_CESIONES);
+
+	/* Con otro proceso que tambien cede se alternan */
+	id=crear_proceso("cedente");
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_CESIONES; i++)
+		ceder_procesador();
+	esperar_proceso(id, 0);
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_ceder: %d cambios de proceso en %llu us (%llu ns por cambio)\n",
+		2*TOT_CESIONES, t/1000, t/(2*TOT_CESIONES));
+
+	/* Hilos verdes: los cambios no entran en el kernel */
+	for (i=0; i<NUM_TAREAS; i++)
+		if (crear_verde(tarea, (void *)(long)i)<0)
+			printf("Error creando tarea verde\n");
+	esperar_hilo(crear_hilo(intruso, 0), &i);
+	printf("prueba_ceder: otro proceso crea una tarea verde: %d (debe ser -1)\n", i);
+	t0=obtener_tiempo_ns();
+	ejecutar_verdes();
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_ceder: %d cambios de tarea verde en %llu us (%llu ns por cambio), %d fuera de turno (debe ser 0)\n",
+		NUM_TAREAS*TOT_CAMBIOS, t/1000, t/(NUM_TAREAS*TOT_CAMBIOS), fuera_de_turno);
+
+	printf("prueba_ceder: termina\n");
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * usuario/prueba_cfs.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que mide el reparto del procesador entre
+ * trabajadores (trabajador_cfs) intensivos de distinto nice y la
+ * latencia de despertar de trabajadores interactivos que compiten con
+ * ellos durante DURACION ticks. Informa del trabajo de cada uno, del
+ * indice de equidad de Jain entre los intensivos de nice 0 (1000 es
+ * reparto perfecto) y del retraso medio y maximo de los interactivos.
+ * Con turno rotatorio el nice no tiene efecto; con CFS (arrancando con
+ * PLANIFICADOR=CFS en el entorno) el de nice 5 debe recibir un tercio
+ * de lo que reciben los de nice 0.
+ */
+
+#include "servicios.h"
+
+#define DURACION 1000	/* ticks que compiten los trabajadores */
+#define NUM_TRABAJADORES 6
+
+struct param_cfs {
+	int interactivo;
+	int nice;
+};
+
+struct res_cfs {
+	int interactivo;
+	int nice;
+	int tandas;			/* trabajo hecho, en tandas de TANDA iteraciones */
+	int despertares;
+	int retraso_total;	/* ticks entre el despertar pedido y el real */
+	int retraso_max;
+};
+
+static struct param_cfs trabajadores[NUM_TRABAJADORES] = {
+	{0, 0}, {0, 0}, {0, 0}, {0, 5}, {1, 0}, {1, 0}
+};
+
+int main(){
+	struct param_cfs par;
+	struct res_cfs res;
+	struct mensaje msj;
+	int *fin;
+	int cfs, rcfs, shm, i, n0;
+	long long suma0, cuad0, total;
+	struct res_cfs resultados[NUM_TRABAJADORES];
+
+	printf("prueba_cfs: comienza\n");
+
+	if ((cfs=crear_cola("cfs", NUM_TRABAJADORES))<0 ||
+		(rcfs=crear_cola("rcfs", NUM_TRABAJADORES))<0 ||
+		(shm=crear_memoria_compartida("fin", sizeof(int), (void **)&fin))<0) {
+		printf("Error creando las colas o la region\n");
+		return 0;
+	}
+
+	*fin=0;
+	for (i=0; i<NUM_TRABAJADORES; i++) {
+		par=trabajadores[i];
+		msj.datos=&par;
+		msj.tam=sizeof(par);
+		msj.prioridad=0;
+		enviar(cfs, &msj, ESPERA_INDEFINIDA);
+		if (crear_proceso("trabajador_cfs")<0)
+			printf("Error creando trabajador_cfs\n");
+	}
+
+	dormir_ticks(DURACION);
+	*fin=1;
+
+	for (i=0; i<NUM_TRABAJADORES; i++) {
+		msj.datos=&res;
+		msj.tam=sizeof(res);
+		recibir(rcfs, &msj, ESPERA_INDEFINIDA);
+		resultados[i]=res;
+	}
+	for (i=0; i<NUM_TRABAJADORES; i++)
+		esperar_proceso(CUALQUIER_HIJO, 0);
+	cerrar_memoria_compartida(shm);
+
+	total=suma0=cuad0=0;
+	n0=0;
+	for (i=0; i<NUM_TRABAJADORES; i++) {
+		total+=resultados[i].tandas;
+		if (!resultados[i].interactivo && resultados[i].nice==0) {
+			suma0+=resultados[i].tandas;
+			cuad0+=(long long)resultados[i].tandas*resultados[i].tandas;
+			n0++;
+		}
+	}
+
+	for (i=0; i<NUM_TRABAJADORES; i++) {
+		res=resultados[i];
+		if (!res.interactivo)
+			printf("prueba_cfs: intensivo nice %d: %d tandas (%d%% del trabajo)\n",
+				res.nice, res.tandas, total>0 ? (int)(res.tandas*100/total) : 0);
+		else
+			printf("prueba_cfs: interactivo nice %d: %d tandas, %d despertares, retraso medio %d.%02d max %d ticks\n",
+				res.nice, res.tandas, res.despertares,
+				res.despertares>0 ? res.retraso_total/res.despertares : 0,
+				res.despertares>0 ? res.retraso_total*100/res.despertares%100 : 0,
+				res.retraso_max);
+	}
+	if (n0>0 && cuad0>0)
+		printf("prueba_cfs: equidad de Jain entre intensivos de nice 0: %d\n",
+			(int)(suma0*suma0*1000/(n0*cuad0)));
+
+	printf("prueba_cfs: termina\n");
+	return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * usuario/prueba_cola.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las colas de mensajes y mide su
+ * latencia y productividad. Para cada tamaño de mensaje realiza
+ * TOT_ITER viajes de ida y vuelta con el proceso eco_cola: los
+ * mensajes pequeños se copian y los grandes se envian cediendo
+ * su buffer, que eco_cola devuelve sin copiarlo.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 2000	/* viajes de ida y vuelta con cada tamaño */
+
+static unsigned int tams[] = {16, 64, 1024, 16384, 65536};
+
+int main(){
+	unsigned long long t0, t;
+	int i, j, ida, vuelta;
+	char buf[TAM_MSJ_PEQ];
+	void *grande;
+	struct mensaje msj;
+
+	printf("prueba_cola: comienza\n");
+
+	if ((ida=crear_cola("ida", 8))<0 || (vuelta=crear_cola("vuelta", 8))<0) {
+		printf("Error creando las colas\n");
+		return 0;
+	}
+
+	/* Prioridades y plazos, sin otros procesos */
+	msj.datos=buf;
+	msj.tam=1; msj.prioridad=1; buf[0]='b';
+	enviar(vuelta, &msj, 0);
+	msj.tam=1; msj.prioridad=5; buf[0]='a';
+	enviar(vuelta, &msj, 0);
+	for (i=0; i<2; i++) {
+		msj.tam=TAM_MSJ_PEQ;
+		recibir(vuelta, &msj, 0);
+		printf("prueba_cola: recibe %c con prioridad %d\n", buf[0], msj.prioridad);
+	}
+	if (recibir(vuelta, &msj, 5)<0)
+		printf("prueba_cola: cola vacia, vence el plazo de 5 ticks. DEBE APARECER\n");
+
+	if (crear_proceso("eco_cola")<0)
+		printf("Error creando eco_cola\n");
+
+	for (i=0; i<sizeof(tams)/sizeof(tams[0]); i++) {
+		grande=0;
+		if (tams[i]>TAM_MSJ_PEQ && reservar_mensaje(tams[i], &grande)<0) {
+			printf("Error reservando mensaje de %d bytes\n", tams[i]);
+			continue;
+		}
+
+		t0=obtener_tiempo_ns();
+		for (j=0; j<TOT_ITER; j++) {
+			msj.datos=grande ? grande : buf;
+			msj.tam=tams[i];
+			msj.prioridad=0;
+			if (enviar(ida, &msj, ESPERA_INDEFINIDA)<0 ||
+				(msj.tam=TAM_MSJ_PEQ, recibir(vuelta, &msj, ESPERA_INDEFINIDA))<0) {
+				printf("Error en el viaje %d\n", j);
+				break;
+			}
+			if (grande)
+				grande=msj.datos;
+		}
+		t=obtener_tiempo_ns()-t0;
+
+		printf("prueba_cola: mensaje %d bytes (%s): %d viajes en %llu us, latencia %llu ns, %llu MB/s\n",
+			tams[i], grande ? "cedido" : "copiado", j, t/1000,
+			(j>0) ? t/j : 0, (t>0) ? 2000ULL*j*tams[i]/t : 0);
+
+		if (grande)
+			liberar_mensaje(grande);
+	}
+
+	/* un mensaje vacio indica a eco_cola que termine */
+	msj.datos=buf;
+	msj.tam=0;
+	enviar(ida, &msj, ESPERA_INDEFINIDA);
+
+	printf("prueba_cola: termina\n");
+	return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * usuario/prueba_cuota.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las cuotas de procesador. Mide el
+ * procesador que obtiene este proceso compitiendo DURACION ticks con
+ * NUM_OCUPADOS procesos (ocupado) que no se bloquean nunca, primero sin
+ * limite y despues con cada uno limitado a CUOTA de cada PERIODO ticks.
+ * Con cuota los ocupados no pueden pasar de su parte aunque no haya
+ * nada mas que hacer, y el resto queda para este proceso.
+ */
+
+#include "servicios.h"
+
+#define NUM_OCUPADOS 8
+#define DURACION 400	/* ticks que dura cada fase */
+#define CUOTA 1
+#define PERIODO 20
+#define TANDA 100000	/* iteraciones entre consultas del reloj */
+
+/* Tandas que hace este proceso en ticks ticks */
+static int trabajar(int ticks){
+	volatile int k;
+	int t_fin, n=0;
+
+	t_fin=tiempos_proceso(0)+ticks;
+	while (tiempos_proceso(0) < t_fin) {
+		for (k=0; k<TANDA; k++);
+		n++;
+	}
+	return n;
+}
+
+/* Procesador (%) que obtiene este proceso frente a los ocupados */
+static int fase(int *fin, int con_cuota, int tandas_solo){
+	struct estad_cuota est;
+	int ids[NUM_OCUPADOS];
+	int i, n, estrangulamientos, ticks_estrangulado, consumo;
+
+	*fin=0;
+	for (i=0; i<NUM_OCUPADOS; i++) {
+		if ((ids[i]=crear_proceso("ocupado"))<0)
+			printf("Error creando ocupado\n");
+		else if (con_cuota && fijar_cuota(ids[i], CUOTA, PERIODO)<0)
+			printf("Error fijando la cuota de %d\n", ids[i]);
+	}
+
+	n=trabajar(DURACION);
+
+	estrangulamientos=ticks_estrangulado=consumo=0;
+	for (i=0; con_cuota && i<NUM_OCUPADOS; i++)
+		if (estadisticas_cuota(ids[i], &est)==0) {
+			estrangulamientos+=est.estrangulamientos;
+			ticks_estrangulado+=est.ticks_estrangulado;
+			consumo+=est.consumo_total;
+		}
+
+	*fin=1;
+	for (i=0; i<NUM_OCUPADOS; i++)
+		esperar_proceso(ids[i], 0);
+
+	if (con_cuota)
+		printf("prueba_cuota: ocupados con cuota %d/%d: %d ticks consumidos (%d%% del procesador), %d estrangulamientos, %d ticks estrangulados\n",
+			CUOTA, PERIODO, consumo, consumo*100/DURACION, estrangulamientos, ticks_estrangulado);
+	return n*100/tandas_solo;
+}
+
+int main(){
+	int *fin;
+	int shm, solo, sin_cuota, con_cuota;
+
+	printf("prueba_cuota: comienza\n");
+
+	if ((shm=crear_memoria_compartida("fin", sizeof(int), (void **)&fin))<0) {
+		printf("Error creando la region fin\n");
+		return 0;
+	}
+
+	if (fijar_cuota(obtener_id_pr(), 5, 5)>=0 || fijar_cuota(obtener_id_pr(), 0, 5)>=0)
+		printf("prueba_cuota: ERROR se admite una cuota sin efecto\n");
+
+	solo=trabajar(DURACION);
+
+	sin_cuota=fase(fin, 0, solo);
+	printf("prueba_cuota: con %d ocupados sin cuota obtiene el %d%% del procesador\n",
+		NUM_OCUPADOS, sin_cuota);
+
+	con_cuota=fase(fin, 1, solo);
+	printf("prueba_cuota: con %d ocupados con cuota %d/%d obtiene el %d%% del procesador (minimo esperado %d%%)\n",
+		NUM_OCUPADOS, CUOTA, PERIODO, con_cuota, 100-NUM_OCUPADOS*CUOTA*100/PERIODO);
+
+	cerrar_memoria_compartida(shm);
+
+	printf("prueba_cuota: termina\n");
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * usuario/prueba_datos.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la pagina de datos del kernel. Compara
+ * las llamadas por tick de obtener_id_pr y tiempos_proceso, que la leen
+ * sin entrar en el kernel, con las de un servicio que si entra
+ * (fijar_nice), comprueba que lo que contiene coincide con lo que
+ * devuelve el kernel y muestra los ticks propios tras trabajar. Termina
+ * escribiendo en la pagina, que es de solo lectura, por lo que debe
+ * acabar por excepcion.
+ */
+
+#include "servicios.h"
+
+#define NUM_LLAMADAS 1000000
+#define NUM_LECTURAS 100000000	/* las que leen la pagina son mucho mas baratas */
+#define TRABAJO 50	/* ticks de trabajo para tiempos_propios */
+
+static struct anillo_llamsis anillo;
+
+/* Llamadas por tick de n llamadas hechas en t ticks */
+static int por_tick(int n, int t){
+	return n/(t>0 ? t : 1);
+}
+
+int main(){
+	const struct datos_kernel *d;
+	struct resultado_llamsis r;
+	struct tiempos_ejec antes, despues;
+	volatile int k;
+	int t0, t1, i;
+
+	printf("prueba_datos: comienza\n");
+
+	if (datos_kernel(&d)<0) {
+		printf("prueba_datos: ERROR obteniendo la pagina\n");
+		return 0;
+	}
+
+	// Contenido de la pagina frente a lo que devuelve el kernel
+	crear_anillo(&anillo);
+	anillo_obtener_id_pr(&anillo, 0);
+	entrar_anillo();
+	anillo_resultado(&anillo, &r);
+	printf("prueba_datos: id en la pagina %d, id del kernel %d\n", obtener_id_pr(), r.res);
+	t0=tiempos_proceso(0);
+	dormir_hasta(t0+5);
+	t1=tiempos_proceso(0);
+	printf("prueba_datos: dormir_hasta(%d) despierta en el tick %d\n", t0+5, t1);
+
+	// Coste de las llamadas que leen la pagina y de una que entra
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LECTURAS; i++)
+		obtener_id_pr();
+	printf("prueba_datos: obtener_id_pr: %d llamadas por tick\n",
+		por_tick(NUM_LECTURAS, tiempos_proceso(0)-t0));
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LECTURAS; i++)
+		tiempos_proceso(0);
+	printf("prueba_datos: tiempos_proceso: %d llamadas por tick\n",
+		por_tick(NUM_LECTURAS, tiempos_proceso(0)-t0));
+	t0=tiempos_proceso(0);
+	for (i=0; i<NUM_LLAMADAS; i++)
+		fijar_nice(0);
+	printf("prueba_datos: fijar_nice (entra en el kernel): %d llamadas por tick\n",
+		por_tick(NUM_LLAMADAS, tiempos_proceso(0)-t0));
+
+	// Ticks propios
+	tiempos_propios(&antes);
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0) < t0+TRABAJO)
+		for (k=0; k<1000; k++);
+	tiempos_propios(&despues);
+	printf("prueba_datos: tras %d ticks de trabajo: usuario %d sistema %d\n", TRABAJO,
+		despues.usuario-antes.usuario, despues.sistema-antes.sistema);
+
+	printf("prueba_datos: escribe en la pagina (debe terminar por excepcion)\n");
+	((struct datos_kernel *)d)->id_actual=0;
+
+	printf("prueba_datos: ERROR la pagina admite escrituras\n");
+	return 0;
+}
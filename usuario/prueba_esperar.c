@@ -0,0 +1,81 @@
+/*
+ * usuario/prueba_esperar.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la espera por hijos: estado de fin
+ * con salir, con return y por excepcion, espera a cualquier hijo,
+ * errores, y coste de un ciclo crear+esperar. Termina dejando hijos
+ * sin esperar, que el kernel debe liberar.
+ */
+
+#include "servicios.h"
+
+#define NUM_HIJOS 5		/* hijos de cada fase */
+#define TOT_ITER 1000	/* ciclos crear+esperar */
+
+int main(){
+	int ids[NUM_HIJOS];
+	unsigned long long t0, t;
+	int i, id, estado;
+
+	printf("prueba_esperar: comienza\n");
+
+	/* Espera a hijos concretos en orden inverso al de creacion */
+	for (i=0; i<NUM_HIJOS; i++)
+		if ((ids[i]=crear_proceso("hijo_estado"))<0)
+			printf("Error creando hijo_estado\n");
+	for (i=NUM_HIJOS-1; i>=0; i--) {
+		id=esperar_proceso(ids[i], &estado);
+		if (id!=ids[i] || estado!=ids[i]%100)
+			printf("prueba_esperar: hijo %d devuelve %d con estado %d. NO DEBE APARECER\n",
+				ids[i], id, estado);
+	}
+	printf("prueba_esperar: %d hijos esperados en orden inverso\n", NUM_HIJOS);
+
+	/* Un hijo ya esperado no se puede volver a esperar */
+	if (esperar_proceso(ids[0], &estado)<0)
+		printf("prueba_esperar: error esperando a un hijo ya esperado. DEBE APARECER\n");
+
+	/* Ni a uno mismo */
+	if (esperar_proceso(obtener_id_pr(), &estado)<0)
+		printf("prueba_esperar: error esperandose a si mismo. DEBE APARECER\n");
+
+	/* Estado de fin al volver de main y por excepcion */
+	id=crear_proceso("simplon");
+	esperar_proceso(id, &estado);
+	printf("prueba_esperar: simplon termina con estado %d (debe ser 0)\n", estado);
+
+	id=crear_proceso("excep_arit");
+	esperar_proceso(id, &estado);
+	printf("prueba_esperar: excep_arit termina con estado %d (debe ser %d)\n",
+		estado, FIN_POR_EXCEPCION);
+
+	/* Espera a cualquier hijo hasta que no queden */
+	for (i=0; i<NUM_HIJOS; i++)
+		crear_proceso("hijo_estado");
+	for (i=0; (id=esperar_proceso(CUALQUIER_HIJO, &estado))>=0; i++)
+		if (estado!=id%100)
+			printf("prueba_esperar: hijo %d con estado %d. NO DEBE APARECER\n", id, estado);
+	printf("prueba_esperar: %d hijos esperados con CUALQUIER_HIJO (debe ser %d)\n", i, NUM_HIJOS);
+
+	/* Coste de crear un hijo y esperarlo */
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i++)
+		esperar_proceso(crear_proceso("hijo_estado"), 0);
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_esperar: %d ciclos crear+esperar en %llu ms (%llu us por ciclo)\n",
+		TOT_ITER, t/1000000, t/1000/TOT_ITER);
+
+	/* Hijos que nunca se esperan */
+	for (i=0; i<NUM_HIJOS; i++)
+		crear_proceso("hijo_estado");
+
+	printf("prueba_esperar: termina\n");
+	return 0;
+}
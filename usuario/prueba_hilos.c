@@ -0,0 +1,117 @@
+/*
+ * usuario/prueba_hilos.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los hilos: comparten las variables
+ * globales del programa, reciben su argumento y devuelven su estado
+ * de fin con esperar_hilo. Compara el coste de crear un hilo con el
+ * de crear un proceso con la imagen en la cache, y el de crear y
+ * esperar uno con el de un proceso con la imagen en la cache y
+ * cargandola cada vez. Termina dejando un hilo
+ * en ejecucion, que debe conservar la imagen hasta acabar.
+ */
+
+#include "servicios.h"
+
+#define NUM_HILOS 8		/* hilos que suman en paralelo */
+#define TOT_SUMAS 100000	/* sumas de cada hilo */
+#define TOT_ITER 2000	/* ciclos crear+esperar */
+#define LOTE 50		/* creaciones seguidas antes de esperarlas */
+
+static int suma[NUM_HILOS];	/* resultados compartidos con los hilos */
+
+static int sumador(void *arg){
+	int i, n = (long)arg;
+
+	for (i=0; i<TOT_SUMAS; i++)
+		suma[n]++;
+	return n;
+}
+
+static int vacio(void *arg){
+	return 0;
+}
+
+static int rezagado(void *arg){
+	dormir(1);
+	printf("prueba_hilos: el ultimo hilo termina despues que el principal\n");
+	return 0;
+}
+
+int main(){
+	int ids[NUM_HILOS], lote[LOTE];
+	int i, j, estado;
+	unsigned long long t0, t, t_proc;
+
+	printf("prueba_hilos: comienza\n");
+
+	for (i=0; i<NUM_HILOS; i++)
+		if ((ids[i]=crear_hilo(sumador, (void *)(long)i))<0)
+			printf("Error creando hilo\n");
+	for (i=0; i<NUM_HILOS; i++) {
+		esperar_hilo(ids[i], &estado);
+		if (estado!=i || suma[i]!=TOT_SUMAS)
+			printf("prueba_hilos: hilo %d estado %d suma %d. NO DEBE APARECER\n",
+				i, estado, suma[i]);
+	}
+	printf("prueba_hilos: %d hilos han sumado en las globales del programa\n", NUM_HILOS);
+
+	// Solo la creacion, en tandas que se esperan despues; una tanda sin
+	// medir hace crecer el pool de pilas para que no lo pague la primera
+	for (j=0; j<LOTE; j++)
+		lote[j]=crear_hilo(vacio, 0);
+	for (j=0; j<LOTE; j++)
+		esperar_hilo(lote[j], 0);
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i+=LOTE) {
+		for (j=0; j<LOTE; j++)
+			lote[j]=crear_hilo(vacio, 0);
+		for (j=0; j<LOTE; j++)
+			esperar_hilo(lote[j], 0);
+	}
+	t=obtener_tiempo_ns()-t0;
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i+=LOTE) {
+		for (j=0; j<LOTE; j++)
+			lote[j]=crear_proceso("hijo_estado");
+		for (j=0; j<LOTE; j++)
+			esperar_proceso(lote[j], 0);
+	}
+	t_proc=obtener_tiempo_ns()-t0;
+	printf("prueba_hilos: %d hilos en tandas de %d: %llu us por hilo; %d procesos con la imagen en cache: %llu us por proceso\n",
+		TOT_ITER, LOTE, t/1000/TOT_ITER, TOT_ITER, t_proc/1000/TOT_ITER);
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i++)
+		esperar_hilo(crear_hilo(vacio, 0), 0);
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_hilos: %d ciclos crear_hilo+esperar_hilo (%llu us por ciclo)\n",
+		TOT_ITER, t/1000/TOT_ITER);
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i++)
+		esperar_proceso(crear_proceso("hijo_estado"), 0);
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_hilos: %d ciclos crear_proceso+esperar_proceso con la imagen en cache (%llu us por ciclo)\n",
+		TOT_ITER, t/1000/TOT_ITER);
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i++) {
+		vaciar_cache_imagenes();
+		esperar_proceso(crear_proceso("hijo_estado"), 0);
+	}
+	t=obtener_tiempo_ns()-t0;
+	printf("prueba_hilos: %d ciclos crear_proceso+esperar_proceso cargando la imagen (%llu us por ciclo)\n",
+		TOT_ITER, t/1000/TOT_ITER);
+
+	crear_hilo(rezagado, 0);
+
+	printf("prueba_hilos: termina\n");
+	return 0;
+}
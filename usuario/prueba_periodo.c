@@ -0,0 +1,81 @@
+/*
+ * usuario/prueba_periodo.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que ejecuta un bucle periodico de 10 ms durante
+ * un minuto compitiendo con un proceso que consume procesador, primero
+ * con plazos absolutos (dormir_hasta) y despues relativos
+ * (dormir_ticks). Informa de la deriva acumulada y de la fluctuacion
+ * del retraso de cada despertar.
+ */
+
+#include "servicios.h"
+
+#define PERIODO 1			/* ticks del periodo (10 ms) */
+#define DURACION 6000		/* ticks de cada fase (un minuto) */
+#define MS_POR_TICK 10		/* milisegundos que dura un tick */
+
+static int min, max, suma, n;	/* retrasos de los despertares de una fase */
+
+static void anotar(int retraso){
+	suma+=retraso;
+	if (retraso<min) min=retraso;
+	if (retraso>max) max=retraso;
+	n++;
+}
+
+static void informe(char *nombre, int t_ini, int t_fin){
+	printf("prueba_periodo: %s: %d periodos de %d esperados, deriva %d ms, retraso medio %d.%d ms, min %d ms, max %d ms, fluctuacion %d ms\n",
+		nombre, n, (t_fin - t_ini)/PERIODO, (t_fin - t_ini - n*PERIODO)*MS_POR_TICK,
+		suma*MS_POR_TICK/n, (suma*MS_POR_TICK*10/n)%10,
+		min*MS_POR_TICK, max*MS_POR_TICK, (max-min)*MS_POR_TICK);
+}
+
+int main(){
+	int *fin;
+	int shm, id, t, t_ini, plazo;
+
+	printf("prueba_periodo: comienza\n");
+
+	if ((shm=crear_memoria_compartida("fin", sizeof(int), (void **)&fin))<0) {
+		printf("Error creando la region fin\n");
+		return 0;
+	}
+	*fin=0;
+	if ((id=crear_proceso("ocupado"))<0)
+		printf("Error creando ocupado\n");
+
+	/* Plazos absolutos: cada retraso se recupera en el siguiente periodo */
+	min=DURACION; max=0; suma=0; n=0;
+	t_ini=t=plazo=tiempos_proceso(0);
+	while (t-t_ini < DURACION) {
+		plazo+=PERIODO;
+		t=dormir_hasta(plazo);
+		anotar(t-plazo);
+	}
+	informe("dormir_hasta", t_ini, t);
+
+	/* Plazos relativos: cada retraso se suma a los anteriores */
+	min=DURACION; max=0; suma=0; n=0;
+	t_ini=t=tiempos_proceso(0);
+	while (t-t_ini < DURACION) {
+		plazo=t+PERIODO;
+		dormir_ticks(PERIODO);
+		t=tiempos_proceso(0);
+		anotar(t-plazo);
+	}
+	informe("dormir_ticks", t_ini, t);
+
+	*fin=1;
+	esperar_proceso(id, 0);
+	cerrar_memoria_compartida(shm);
+
+	printf("prueba_periodo: termina\n");
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * usuario/prueba_pipe.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que mide el rendimiento de los pipes. Para cada
+ * tamaño de buffer crea un pipe anonimo, arranca un proceso productor
+ * que lo hereda y consume TOT_BYTES bytes midiendo los ticks empleados.
+ * Despues prueba el modo no bloqueante, los extremos de solo lectura y
+ * solo escritura y el fin de fichero de un pipe con nombre.
+ */
+
+#include "servicios.h"
+
+#define TOT_BYTES 1048576	/* bytes a transferir con cada tamaño de buffer */
+#define TAM_LECTURA 1024	/* bytes solicitados en cada lectura */
+#define BYTES_ECO 5000		/* bytes que escribe el productor del pipe con nombre */
+
+static unsigned int tams[] = {16, 64, 256, 1024, 4096};
+
+int main(){
+	int i, desc, lec, esc, id, n, leidos, t0, t1;
+	char buf[TAM_LECTURA], args[TAM_ARGUMENTOS]="pipe=eco";
+
+	printf("prueba_pipe: comienza\n");
+
+	for (i=0; i<sizeof(tams)/sizeof(tams[0]); i++) {
+
+		/* el productor hereda el pipe en el mismo descriptor (0) */
+		if ((desc=crear_pipe(0, tams[i], PIPE_BLOQUEANTE))!=0) {
+			printf("Error creando pipe de %d bytes\n", tams[i]);
+			continue;
+		}
+
+		if (crear_proceso("productor")<0)
+			printf("Error creando productor\n");
+
+		t0=tiempos_proceso(0);
+		for (leidos=0; leidos<TOT_BYTES; leidos+=n)
+			if ((n=leer_pipe(desc, buf, TAM_LECTURA))<=0)
+				break;
+		t1=tiempos_proceso(0);
+
+		printf("prueba_pipe: buffer %d bytes: %d bytes en %d ticks (%d bytes/tick)\n",
+			tams[i], leidos, t1-t0, (t1>t0) ? leidos/(t1-t0) : leidos);
+
+		/* al cerrar, el productor queda solo y su escritura falla */
+		cerrar_pipe(desc);
+	}
+
+	/* Modo no bloqueante con un extremo de lectura y otro de escritura */
+	if ((lec=crear_pipe("np", 16, PIPE_NO_BLOQUEANTE|PIPE_SOLO_LECTURA))<0 ||
+		(esc=abrir_pipe("np", PIPE_NO_BLOQUEANTE|PIPE_SOLO_ESCRITURA))<0)
+		printf("prueba_pipe: error creando el pipe np. NO DEBE APARECER\n");
+
+	if (leer_pipe(lec, buf, 1)<0)
+		printf("prueba_pipe: lectura no bloqueante de pipe vacio. DEBE APARECER\n");
+	printf("prueba_pipe: escritura no bloqueante de 20 bytes en 16 de buffer: %d (debe ser 16)\n",
+		escribir_pipe(esc, buf, 20));
+	if (escribir_pipe(esc, buf, 1)<0)
+		printf("prueba_pipe: escritura no bloqueante en pipe lleno. DEBE APARECER\n");
+	if (leer_pipe(esc, buf, 1)<0)
+		printf("prueba_pipe: lectura de un extremo de escritura. DEBE APARECER\n");
+	if (escribir_pipe(lec, buf, 1)<0)
+		printf("prueba_pipe: escritura en un extremo de lectura. DEBE APARECER\n");
+	printf("prueba_pipe: lectura de 16 bytes: %d\n", leer_pipe(lec, buf, TAM_LECTURA));
+
+	/* sin extremos de escritura se lee fin de fichero, no se bloquea */
+	cerrar_pipe(esc);
+	printf("prueba_pipe: lectura sin extremos de escritura: %d (debe ser 0)\n",
+		leer_pipe(lec, buf, TAM_LECTURA));
+	cerrar_pipe(lec);
+
+	/* Fin de fichero de un pipe con nombre que otros hijos no heredan */
+	if ((lec=crear_pipe("eco", 64, PIPE_SOLO_LECTURA|PIPE_NO_HEREDAR))<0 ||
+		(esc=abrir_pipe("eco", PIPE_SOLO_ESCRITURA|PIPE_NO_HEREDAR))<0)
+		printf("prueba_pipe: error creando el pipe eco. NO DEBE APARECER\n");
+
+	/* sin heredar el pipe este productor no tiene descriptor 0: escribe 0 bytes */
+	if (crear_proceso("productor")<0)
+		printf("Error creando productor\n");
+	poner_argumento(args, TAM_ARGUMENTOS, "bytes", BYTES_ECO);
+	if ((id=crear_proceso_args("productor", args))<0)
+		printf("Error creando productor\n");
+
+	/* el extremo propio de escritura evita el fin de fichero hasta que
+	   el productor ha abierto el suyo, lo que ocurre antes de escribir */
+	leidos=leer_pipe(lec, buf, TAM_LECTURA);
+	cerrar_pipe(esc);
+	while ((n=leer_pipe(lec, buf, TAM_LECTURA))>0)
+		leidos+=n;
+	printf("prueba_pipe: fin de fichero tras leer %d bytes del pipe eco (debe ser %d)\n",
+		leidos, BYTES_ECO);
+	esperar_proceso(id, 0);
+	cerrar_pipe(lec);
+
+	printf("prueba_pipe: termina\n");
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * usuario/prueba_procs.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que somete a la tabla de procesos a una carga
+ * de miles de creaciones, en tandas de TAM_TANDA procesos vivos a la
+ * vez. Comprueba que ningun id se repite entre una tanda y la
+ * siguiente aunque se reutilicen las entradas, y mide cuantos
+ * procesos se crean por tick.
+ */
+
+#include "servicios.h"
+
+#define TOT_TANDAS 100	/* tandas de creaciones */
+#define TAM_TANDA 50	/* procesos vivos a la vez en cada tanda */
+
+static int ids[2][TAM_TANDA];
+
+int main(){
+	int i, j, n, t, desc, t0, t1, repetidos=0, creados=0;
+	char buf[TAM_TANDA];
+
+	printf("prueba_procs: comienza\n");
+
+	/* los hijos heredan el pipe en el mismo descriptor (0) */
+	if ((desc=crear_pipe(0, TAM_TANDA, PIPE_BLOQUEANTE))!=0) {
+		printf("Error creando pipe\n");
+		return 0;
+	}
+
+	t0=tiempos_proceso(0);
+	for (t=0; t<TOT_TANDAS; t++) {
+		for (i=0; i<TAM_TANDA; i++) {
+			if ((ids[t%2][i]=crear_proceso("hijo_spawn"))<0) {
+				printf("Error creando hijo_spawn\n");
+				return 0;
+			}
+			creados++;
+
+			/* las entradas de la tanda anterior ya estan libres */
+			for (j=0; t>0 && j<TAM_TANDA; j++)
+				if (ids[t%2][i]==ids[(t+1)%2][j])
+					repetidos++;
+		}
+
+		/* espera a que termine toda la tanda */
+		for (i=0; i<TAM_TANDA; i+=n)
+			if ((n=leer_pipe(desc, buf, TAM_TANDA-i))<=0) {
+				printf("Error leyendo del pipe (%d)\n", n);
+				return 0;
+			}
+		for (i=0; i<TAM_TANDA; i++)
+			esperar_proceso(ids[t%2][i], 0);
+	}
+	t1=tiempos_proceso(0);
+
+	printf("prueba_procs: %d procesos en %d ticks (%d procesos/tick), %d ids repetidos (debe ser 0)\n",
+		creados, t1-t0, (t1>t0) ? creados/(t1-t0) : creados, repetidos);
+	printf("prueba_procs: ultimo id %d\n", ids[(TOT_TANDAS-1)%2][TAM_TANDA-1]);
+
+	printf("prueba_procs: termina\n");
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * usuario/prueba_reloj.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los relojes obtener_tiempo_ns y
+ * obtener_hora. Mide la resolucion y el coste de obtener_tiempo_ns,
+ * comprueba que no retrocede y que, durmiendo ESPERA ticks, los tres
+ * relojes (ticks, ns y hora) avanzan lo mismo, y muestra la hora.
+ */
+
+#include "servicios.h"
+
+#define NUM_LLAMADAS 100000
+#define ESPERA 50		/* ticks (a TICK por segundo) */
+
+/* Escribe la hora UTC de ms desde el 1 de enero de 1970 */
+static void mostrar_hora(unsigned long long ms){
+	long long dias=ms/1000/86400, seg=ms/1000%86400;
+	long long era, dde, ade, a, dda, m, d;
+
+	/* fecha civil a partir de los dias desde 1970 */
+	dias+=719468;
+	era=dias/146097;
+	dde=dias-era*146097;
+	ade=(dde-dde/1460+dde/36524-dde/146096)/365;
+	a=ade+era*400;
+	dda=dde-(365*ade+ade/4-ade/100);
+	m=(5*dda+2)/153;
+	d=dda-(153*m+2)/5+1;
+	m=m<10 ? m+3 : m-9;
+	if (m<=2)
+		a++;
+	printf("prueba_reloj: hora %04lld-%02lld-%02lld %02lld:%02lld:%02lld.%03lld UTC\n",
+		a, m, d, seg/3600, seg/60%60, seg%60, (long long)(ms%1000));
+}
+
+int main(){
+	unsigned long long t, ant, min_dif, ns0, ns1, hora0, hora1;
+	int i, retrocesos, t0, t1;
+
+	printf("prueba_reloj: comienza\n");
+
+	// Resolucion, monotonia y coste
+	min_dif=~0ULL;
+	retrocesos=0;
+	ant=obtener_tiempo_ns();
+	for (i=0; i<NUM_LLAMADAS; i++) {
+		t=obtener_tiempo_ns();
+		if (t<ant)
+			retrocesos++;
+		else if (t>ant && t-ant<min_dif)
+			min_dif=t-ant;
+		ant=t;
+	}
+	ns0=obtener_tiempo_ns();
+	for (i=0; i<NUM_LLAMADAS; i++)
+		obtener_tiempo_ns();
+	ns1=obtener_tiempo_ns();
+	printf("prueba_reloj: obtener_tiempo_ns: resolucion observada %llu ns, coste %llu ns por llamada, %d retrocesos\n",
+		min_dif, (ns1-ns0)/NUM_LLAMADAS, retrocesos);
+
+	// Los tres relojes frente a una espera conocida
+	t0=tiempos_proceso(0);
+	ns0=obtener_tiempo_ns();
+	hora0=obtener_hora();
+	dormir_ticks(ESPERA);
+	t1=tiempos_proceso(0);
+	ns1=obtener_tiempo_ns();
+	hora1=obtener_hora();
+	printf("prueba_reloj: durmiendo %d ticks: %d ticks, %llu ms segun obtener_tiempo_ns, %llu ms segun obtener_hora\n",
+		ESPERA, t1-t0, (ns1-ns0)/1000000, hora1-hora0);
+	printf("prueba_reloj: %llu ms desde el arranque\n", ns1/1000000);
+	mostrar_hora(hora1);
+
+	printf("prueba_reloj: termina\n");
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * usuario/prueba_shm.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la memoria compartida. Crea la region
+ * "datos", la rellena y arranca dos procesos sumador_shm que la suman
+ * sin copiarla, dejando el resultado en la propia region.
+ */
+
+#include "servicios.h"
+#include "datos_shm.h"
+
+#define NUM_SUMADORES 2
+
+int main(){
+	int i, desc;
+	struct datos_compartidos *d;
+
+	printf("prueba_shm: comienza\n");
+
+	if (abrir_memoria_compartida("datos", (void **)&d)<0)
+		printf("error abriendo region inexistente. DEBE APARECER\n");
+
+	if ((desc=crear_memoria_compartida("datos", sizeof(*d), (void **)&d))<0) {
+		printf("Error creando la region\n");
+		return 0;
+	}
+
+	/* mutex para actualizar la suma desde varios procesos */
+	if (crear_mutex("shm", NO_RECURSIVO)<0)
+		printf("Error creando mutex\n");
+
+	for (i=0; i<NUM_ENTEROS; i++)
+		d->valores[i]=i+1;
+
+	for (i=0; i<NUM_SUMADORES; i++)
+		if (crear_proceso("sumador_shm")<0)
+			printf("Error creando sumador_shm\n");
+
+	while (d->n_terminados<NUM_SUMADORES)
+		dormir(1);
+
+	printf("prueba_shm: suma %d (debe ser %d)\n", d->suma,
+		NUM_SUMADORES*(NUM_ENTEROS*(NUM_ENTEROS+1)/2));
+
+	/* la region se libera al cerrarla su ultimo usuario */
+	cerrar_memoria_compartida(desc);
+
+	printf("prueba_shm: termina\n");
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * usuario/prueba_spawn.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que compara el coste de crear procesos con la
+ * imagen del programa en frio (vaciando la cache antes de cada
+ * creacion) y en caliente (imagen residente en la cache). Cada hijo
+ * avisa de que ha terminado escribiendo un byte en el pipe heredado.
+ */
+
+#include "servicios.h"
+
+#define TOT_ITER 5000	/* procesos creados en cada fase */
+
+/* Devuelve los ns que tarda la fase */
+static unsigned long long fase(int desc, int frio) {
+	unsigned long long t0;
+	int i, id;
+	char c;
+
+	t0=obtener_tiempo_ns();
+	for (i=0; i<TOT_ITER; i++) {
+		if (frio)
+			vaciar_cache_imagenes();
+		if ((id=crear_proceso("hijo_spawn"))<0) {
+			printf("Error creando hijo_spawn\n");
+			break;
+		}
+		leer_pipe(desc, &c, 1);
+		esperar_proceso(id, 0);
+	}
+	return obtener_tiempo_ns()-t0;
+}
+
+int main(){
+	unsigned long long t;
+	int desc;
+	struct estad_imagenes est;
+	struct estad_pilas est_pilas;
+
+	printf("prueba_spawn: comienza\n");
+
+	/* los hijos heredan el pipe en el mismo descriptor (0) */
+	if ((desc=crear_pipe(0, 64, PIPE_BLOQUEANTE))!=0) {
+		printf("Error creando pipe\n");
+		return 0;
+	}
+
+	t=fase(desc, 1);
+	printf("prueba_spawn: en frio %d procesos en %llu ms (%llu us por proceso)\n",
+		TOT_ITER, t/1000000, t/1000/TOT_ITER);
+
+	t=fase(desc, 0);
+	printf("prueba_spawn: en caliente %d procesos en %llu ms (%llu us por proceso)\n",
+		TOT_ITER, t/1000000, t/1000/TOT_ITER);
+
+	estadisticas_imagenes(&est);
+	printf("prueba_spawn: cache de imagenes: %d aciertos %d fallos %d expulsiones %d residentes\n",
+		est.aciertos, est.fallos, est.expulsiones, est.residentes);
+
+	estadisticas_pilas(&est_pilas);
+	printf("prueba_spawn: pool de pilas: %d aciertos %d fallos %d libres\n",
+		est_pilas.aciertos, est_pilas.fallos, est_pilas.libres);
+
+	printf("prueba_spawn: termina\n");
+	return 0;
+}
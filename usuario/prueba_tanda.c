@@ -0,0 +1,77 @@
+/*
+ * usuario/prueba_tanda.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que compara crear tandas de procesos con un
+ * bucle de llamadas crear_proceso frente a una sola llamada
+ * crear_procesos. Cada hijo avisa de que ha terminado escribiendo un
+ * byte en el pipe heredado.
+ */
+
+#include "servicios.h"
+
+#define TOT_TANDAS 200	/* tandas creadas en cada fase */
+#define TAM_TANDA 32	/* procesos de cada tanda */
+
+static int ids[TAM_TANDA];
+
+/* Devuelve los ns que tarda la fase */
+static unsigned long long fase(int desc, int en_bloque) {
+	unsigned long long t0;
+	int i, t, n, leidos;
+	char buf[TAM_TANDA];
+
+	t0=obtener_tiempo_ns();
+	for (t=0; t<TOT_TANDAS; t++) {
+		if (en_bloque)
+			n=crear_procesos("hijo_spawn", TAM_TANDA, ids);
+		else
+			for (n=0; n<TAM_TANDA && (ids[n]=crear_proceso("hijo_spawn"))>=0; n++);
+		if (n!=TAM_TANDA) {
+			printf("Error creando hijo_spawn\n");
+			break;
+		}
+
+		/* espera a que termine toda la tanda */
+		for (i=0; i<TAM_TANDA; i+=leidos)
+			if ((leidos=leer_pipe(desc, buf, TAM_TANDA-i))<=0) {
+				printf("Error leyendo del pipe (%d)\n", leidos);
+				return obtener_tiempo_ns()-t0;
+			}
+		for (i=0; i<TAM_TANDA; i++)
+			esperar_proceso(ids[i], 0);
+	}
+	return obtener_tiempo_ns()-t0;
+}
+
+int main(){
+	unsigned long long t;
+	int desc;
+
+	printf("prueba_tanda: comienza\n");
+
+	/* los hijos heredan el pipe en el mismo descriptor (0) */
+	if ((desc=crear_pipe(0, TAM_TANDA, PIPE_BLOQUEANTE))!=0) {
+		printf("Error creando pipe\n");
+		return 0;
+	}
+
+	t=fase(desc, 0);
+	printf("prueba_tanda: bucle de crear_proceso: %d procesos en %llu ms (%llu us por proceso)\n",
+		TOT_TANDAS*TAM_TANDA, t/1000000, t/1000/(TOT_TANDAS*TAM_TANDA));
+
+	t=fase(desc, 1);
+	printf("prueba_tanda: crear_procesos: %d procesos en %llu ms (%llu us por proceso)\n",
+		TOT_TANDAS*TAM_TANDA, t/1000000, t/1000/(TOT_TANDAS*TAM_TANDA));
+
+	printf("prueba_tanda: ultimos ids %d..%d\n", ids[0], ids[TAM_TANDA-1]);
+
+	printf("prueba_tanda: termina\n");
+	return 0;
+}
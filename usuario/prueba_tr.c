@@ -0,0 +1,124 @@
+/*
+ * usuario/prueba_tr.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la planificacion EDF de procesos
+ * periodicos con conjuntos de NUM_TAREAS tareas (tarea_tr) de
+ * utilizacion creciente, mas un proceso de turno rotatorio que
+ * consume el resto del procesador. Informa de las tareas rechazadas
+ * por el control de admision y de la tasa de plazos incumplidos. El
+ * ultimo conjunto declara menos coste del que consume (sobrecarga).
+ */
+
+#include "servicios.h"
+
+#define NUM_TAREAS 4
+#define DURACION 500	/* ticks que dura cada conjunto */
+#define NUM_CONJUNTOS 6
+
+struct param_tr {
+	int periodo;
+	int coste;			/* declarado en la admision */
+	int coste_real;		/* consumido en cada trabajo */
+	int iter_por_tick;
+	int trabajos;
+};
+
+struct res_tr {
+	int admitida;
+	int activaciones;
+	int fallos;
+};
+
+static int periodos[NUM_TAREAS] = {20, 40, 50, 100};
+
+/* utilizacion (%) declarada y real de cada conjunto */
+static int util_declarada[NUM_CONJUNTOS] = {40, 60, 80, 95, 110, 80};
+static int util_real[NUM_CONJUNTOS] = {40, 60, 80, 95, 110, 120};
+
+/* Iteraciones de bucle vacio que caben en un tick (en tandas grandes
+   para que no cuente el coste de consultar el reloj) */
+static int calibrar(){
+	volatile int k;
+	int t0, t, n=0;
+
+	for (t0=tiempos_proceso(0); (t=tiempos_proceso(0))==t0; );
+	while (tiempos_proceso(0) < t+50) {
+		for (k=0; k<1000000; k++);
+		n++;
+	}
+	return n*1000000/50;
+}
+
+int main(){
+	struct param_tr par;
+	struct res_tr res;
+	struct mensaje msj;
+	int *fin;
+	int tr, cres, shm, ocupado, iter, c, i, util, rechazadas, activaciones, fallos;
+
+	printf("prueba_tr: comienza\n");
+
+	if ((tr=crear_cola("tr", NUM_TAREAS))<0 || (cres=crear_cola("res", NUM_TAREAS))<0 ||
+		(shm=crear_memoria_compartida("fin", sizeof(int), (void **)&fin))<0) {
+		printf("Error creando las colas o la region\n");
+		return 0;
+	}
+
+	iter=calibrar();
+	printf("prueba_tr: %d iteraciones por tick\n", iter);
+
+	*fin=0;
+	ocupado=crear_proceso("ocupado");
+
+	for (c=0; c<NUM_CONJUNTOS; c++) {
+		util=0;
+		for (i=0; i<NUM_TAREAS; i++) {
+			par.periodo=periodos[i];
+			par.coste=util_declarada[c]*periodos[i]/(100*NUM_TAREAS);
+			par.coste_real=util_real[c]*periodos[i]/(100*NUM_TAREAS);
+			par.iter_por_tick=iter;
+			par.trabajos=DURACION/periodos[i];
+			util+=par.coste*1000/par.periodo;
+
+			msj.datos=&par;
+			msj.tam=sizeof(par);
+			msj.prioridad=0;
+			enviar(tr, &msj, ESPERA_INDEFINIDA);
+			if (crear_proceso("tarea_tr")<0)
+				printf("Error creando tarea_tr\n");
+		}
+
+		rechazadas=activaciones=fallos=0;
+		for (i=0; i<NUM_TAREAS; i++) {
+			msj.datos=&res;
+			msj.tam=sizeof(res);
+			recibir(cres, &msj, ESPERA_INDEFINIDA);
+			if (!res.admitida)
+				rechazadas++;
+			else {
+				activaciones+=res.activaciones;
+				fallos+=res.fallos;
+			}
+		}
+		for (i=0; i<NUM_TAREAS; i++)
+			esperar_proceso(CUALQUIER_HIJO, 0);
+
+		printf("prueba_tr: utilizacion declarada %d.%d real %d%%: %d rechazadas, %d de %d plazos incumplidos (%d%%)\n",
+			util/10, util%10, util_real[c], rechazadas, fallos, activaciones,
+			(activaciones>0) ? fallos*100/activaciones : 0);
+	}
+
+	*fin=1;
+	esperar_proceso(ocupado, 0);
+	cerrar_memoria_compartida(shm);
+
+	printf("prueba_tr: termina\n");
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * usuario/secciones.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que muestra las secciones criticas del kernel (el
+ * tiempo con el nivel de interrupcion subido) desde el arranque: tras
+ * esperar los ticks del argumento espera (0 por defecto), lista los
+ * MAX_LINEAS puntos del kernel con la seccion mas larga, con cuantas
+ * han abierto, su duracion media y maxima y su histograma. Mejor junto
+ * con otros procesos (p.ej. bench/carga).
+ */
+
+#include "servicios.h"
+
+#define MAX_SECCIONES 128
+#define MAX_LINEAS 15
+
+static struct estad_seccion secciones[MAX_SECCIONES];
+
+/* Muestra las cubetas no vacias del histograma como "desde_us:veces" */
+static void mostrar_histograma(unsigned int *h){
+	int i;
+
+	for (i=0; i<CUBETAS_SECCION; i++)
+		if (h[i]>0) {
+			if (i==0)
+				printf(" <1:%u", h[i]);
+			else
+				printf(" %u:%u", 1<<(i-1), h[i]);
+		}
+	printf("\n");
+}
+
+int main(){
+	char args[TAM_ARGUMENTOS];
+	struct estad_seccion aux;
+	int n, i, j;
+
+	argumentos(args, TAM_ARGUMENTOS);
+	dormir_ticks(argumento_entero(args, "espera", 0));
+
+	if ((n=estadisticas_secciones(secciones, MAX_SECCIONES))<0) {
+		printf("secciones: error leyendo las estadisticas\n");
+		return 0;
+	}
+	if (n > MAX_SECCIONES)
+		n=MAX_SECCIONES;
+
+	// Ordenacion por insercion por la seccion mas larga
+	for (i=1; i<n; i++)
+		for (j=i; j>0 && secciones[j].ns_max > secciones[j-1].ns_max; j--) {
+			aux=secciones[j];
+			secciones[j]=secciones[j-1];
+			secciones[j-1]=aux;
+		}
+
+	printf("secciones: %d puntos del kernel; histograma en us desde:veces\n", n);
+	printf("%-26s %5s %3s %8s %9s %9s  %s\n", "funcion", "linea", "niv",
+		"veces", "medio(us)", "max(us)", "histograma");
+	for (i=0; i<n && i<MAX_LINEAS; i++) {
+		printf("%-26s %5d %3d %8u %9llu %9llu ", secciones[i].funcion,
+			secciones[i].linea, secciones[i].nivel, secciones[i].veces,
+			secciones[i].ns_total/1000/secciones[i].veces, secciones[i].ns_max/1000);
+		mostrar_histograma(secciones[i].histograma);
+	}
+	return 0;
+}
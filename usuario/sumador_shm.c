@@ -0,0 +1,41 @@
+/*
+ * usuario/sumador_shm.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que suma los enteros de la region compartida
+ * "datos" y acumula el resultado en ella.
+ */
+
+#include "servicios.h"
+#include "datos_shm.h"
+
+int main(){
+	int i, id, m, suma=0;
+	struct datos_compartidos *d;
+
+	id=obtener_id_pr();
+	if (abrir_memoria_compartida("datos", (void **)&d)<0 ||
+		(m=abrir_mutex("shm"))<0) {
+		printf("sumador_shm (%d): error abriendo la region\n", id);
+		return 0;
+	}
+
+	for (i=0; i<NUM_ENTEROS; i++)
+		suma+=d->valores[i];
+
+	lock(m);
+	d->suma+=suma;
+	d->n_terminados++;
+	unlock(m);
+
+	printf("sumador_shm (%d): suma parcial %d\n", id, suma);
+
+	/* cierre implicito de la region y del mutex */
+	return 0;
+}
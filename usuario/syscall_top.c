@@ -0,0 +1,91 @@
+/*
+ * usuario/syscall_top.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que muestra los servicios que mas tiempo de
+ * sistema consumen. Cada INTERVALO ticks, NUM_MUESTRAS veces, lista los
+ * MAX_LINEAS servicios con mas tiempo de sistema (con el procesador)
+ * acumulado en el intervalo por todos los procesos: llamadas, bloqueos,
+ * errores, tiempo de sistema, tiempo total incluido el bloqueado, medio
+ * y maximo (este ultimo desde el arranque). Al final lista lo mismo
+ * desde el arranque.
+ */
+
+#include "servicios.h"
+
+#define MAX_SERVICIOS 64
+#define INTERVALO 100		/* ticks entre muestras */
+#define NUM_MUESTRAS 5
+#define MAX_LINEAS 8
+
+static struct estad_llamsis antes[MAX_SERVICIOS], ahora[MAX_SERVICIOS];
+
+/* Imprime los servicios con mas tiempo entre dos tomas de estadisticas */
+static void mostrar(struct estad_llamsis *ini, struct estad_llamsis *fin, int n){
+	contadores_llamsis d[MAX_SERVICIOS];
+	int orden[MAX_SERVICIOS];
+	unsigned long long total=0;
+	int i, j, aux;
+
+	for (i=0; i<n; i++) {
+		d[i].llamadas=fin[i].c.llamadas-ini[i].c.llamadas;
+		d[i].bloqueos=fin[i].c.bloqueos-ini[i].c.bloqueos;
+		d[i].errores=fin[i].c.errores-ini[i].c.errores;
+		d[i].ns_total=fin[i].c.ns_total-ini[i].c.ns_total;
+		d[i].ns_sistema=fin[i].c.ns_sistema-ini[i].c.ns_sistema;
+		d[i].ns_max=fin[i].c.ns_max;
+		total+=d[i].ns_sistema;
+		orden[i]=i;
+	}
+
+	/* n es pequeño: ordenacion por insercion por tiempo de sistema */
+	for (i=1; i<n; i++)
+		for (j=i; j>0 && d[orden[j]].ns_sistema > d[orden[j-1]].ns_sistema; j--) {
+			aux=orden[j];
+			orden[j]=orden[j-1];
+			orden[j-1]=aux;
+		}
+
+	printf("%-22s %9s %8s %7s %8s %4s %9s %9s %9s\n", "servicio", "llamadas",
+		"bloqueos", "errores", "sis(ms)", "%", "total(ms)", "medio(us)", "max(us)");
+	for (i=0; i<n && i<MAX_LINEAS && d[orden[i]].llamadas>0; i++) {
+		j=orden[i];
+		printf("%-22s %9u %8u %7u %8llu %4llu %9llu %9llu %9llu\n", fin[j].nombre,
+			d[j].llamadas, d[j].bloqueos, d[j].errores, d[j].ns_sistema/1000000,
+			total>0 ? d[j].ns_sistema*100/total : 0, d[j].ns_total/1000000,
+			d[j].ns_total/1000/d[j].llamadas, d[j].ns_max/1000);
+	}
+}
+
+int main(){
+	struct estad_llamsis cero[MAX_SERVICIOS];
+	int n, m, i;
+
+	if ((n=estadisticas_llamsis(LLAMSIS_GLOBAL, antes, MAX_SERVICIOS))<0) {
+		printf("syscall_top: error leyendo las estadisticas\n");
+		return 0;
+	}
+	if (n > MAX_SERVICIOS)
+		n=MAX_SERVICIOS;
+
+	for (m=1; m<=NUM_MUESTRAS; m++) {
+		dormir_ticks(INTERVALO);
+		estadisticas_llamsis(LLAMSIS_GLOBAL, ahora, n);
+		printf("syscall_top: muestra %d de %d (%d ticks)\n", m, NUM_MUESTRAS, INTERVALO);
+		mostrar(antes, ahora, n);
+		for (i=0; i<n; i++)
+			antes[i]=ahora[i];
+	}
+
+	for (i=0; i<n; i++)
+		cero[i].c.llamadas=cero[i].c.bloqueos=cero[i].c.errores=cero[i].c.ns_total=cero[i].c.ns_sistema=0;
+	printf("syscall_top: desde el arranque\n");
+	mostrar(cero, ahora, n);
+	return 0;
+}
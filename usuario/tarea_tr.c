@@ -0,0 +1,66 @@
+/*
+ * usuario/tarea_tr.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que ejecuta una tarea periodica de prueba_tr.
+ * Recibe sus parametros por la cola "tr", pide su admision y, si se
+ * admite, ejecuta sus trabajos consumiendo en cada uno coste_real
+ * ticks de procesador. Devuelve sus contadores por la cola "res".
+ */
+
+#include "servicios.h"
+
+struct param_tr {
+	int periodo;
+	int coste;			/* declarado en la admision */
+	int coste_real;		/* consumido en cada trabajo */
+	int iter_por_tick;
+	int trabajos;
+};
+
+struct res_tr {
+	int admitida;
+	int activaciones;
+	int fallos;
+};
+
+int main(){
+	struct param_tr par;
+	struct res_tr res;
+	struct estad_tr est;
+	struct mensaje msj;
+	volatile int k;
+	int tr, cres, i, n;
+
+	if ((tr=abrir_cola("tr"))<0 || (cres=abrir_cola("res"))<0) {
+		printf("tarea_tr: error abriendo las colas\n");
+		return 0;
+	}
+	msj.datos=&par;
+	msj.tam=sizeof(par);
+	recibir(tr, &msj, ESPERA_INDEFINIDA);
+
+	res.admitida=(crear_temporizador_periodico(par.periodo, par.periodo, par.coste)==0);
+	if (res.admitida) {
+		n=par.coste_real*par.iter_por_tick;
+		for (i=0; i<par.trabajos; i++) {
+			for (k=0; k<n; k++);
+			esperar_periodo();
+		}
+		estadisticas_tr(&est);
+		res.activaciones=est.activaciones;
+		res.fallos=est.fallos;
+	}
+
+	msj.datos=&res;
+	msj.tam=sizeof(res);
+	msj.prioridad=0;
+	enviar(cres, &msj, ESPERA_INDEFINIDA);
+	return 0;
+}
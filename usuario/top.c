@@ -0,0 +1,141 @@
+/*
+ * usuario/top.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que muestra el estado del sistema a partir de
+ * foto_procesos. Cada segundo, NUM_MUESTRAS veces, lista el recuento
+ * de procesos por estado, los MAX_LINEAS procesos que mas procesador
+ * han usado en el ultimo segundo y, para cada proceso bloqueado, lo
+ * que esta esperando.
+ */
+
+#include "servicios.h"
+
+#define MAX_PROCS_TOP 64
+#define NUM_MUESTRAS 10
+#define MAX_LINEAS 8
+
+static struct info_proc antes[MAX_PROCS_TOP], ahora[MAX_PROCS_TOP];
+
+static char *estados[] = {"TERMINADO", "LISTO", "EJECUCION", "BLOQUEADO",
+	"DORMIDO", "MUTEX", "TERMINAL", "PIPE_LEC", "PIPE_ESC", "COLA_REC",
+	"COLA_ENV", "ZOMBI", "HIJO", "ESTRANGULADO"};
+
+/* Ticks usados por el proceso p desde la muestra anterior */
+static unsigned long long uso(struct info_proc *p, int n_antes){
+	unsigned long long t=p->ticks_usuario+p->ticks_sistema;
+	int i;
+
+	for (i=0; i<n_antes; i++)
+		if (antes[i].id==p->id)
+			return t-(antes[i].ticks_usuario+antes[i].ticks_sistema);
+	return t;
+}
+
+/* Escribe lo que espera un proceso bloqueado */
+static void mostrar_espera(struct info_proc *p, unsigned long long ticks){
+	printf("  %5d %-16s ", p->id, p->prog);
+	switch (p->estado) {
+		case DORMIDO:
+			printf("duerme hasta el tick %u (faltan %d)\n", p->t_wake, (int)(p->t_wake-ticks));
+			break;
+		case BLOQUEADO_MTX:
+			printf("espera el mutex %d (%s), que tiene %d\n", p->espera, p->nombre_espera, p->dueno_espera);
+			break;
+		case BLOQUEADO_TERM:
+			printf("espera un caracter del terminal\n");
+			break;
+		case BLOQUEADO_PIPE_LEC:
+		case BLOQUEADO_PIPE_ESC:
+			printf("espera %s en el pipe %d (%s)\n", p->estado==BLOQUEADO_PIPE_LEC ? "datos" : "hueco",
+				p->espera, p->nombre_espera[0] ? p->nombre_espera : "anonimo");
+			break;
+		case BLOQUEADO_COLA_REC:
+		case BLOQUEADO_COLA_ENV:
+			printf("espera %s en la cola %d (%s)\n", p->estado==BLOQUEADO_COLA_REC ? "un mensaje" : "hueco",
+				p->espera, p->nombre_espera);
+			break;
+		case BLOQUEADO_HIJO:
+			printf("espera a que termine un hijo\n");
+			break;
+		case ESTRANGULADO:
+			printf("ha agotado su cuota de procesador\n");
+			break;
+		default:
+			printf("%s\n", estados[p->estado]);
+	}
+}
+
+static void mostrar(struct foto_sistema *f, int n, int n_antes, int ticks){
+	unsigned long long d[MAX_PROCS_TOP];
+	int orden[MAX_PROCS_TOP];
+	int i, j, aux;
+
+	printf("top: tick %llu: %d procesos, %d listos, %d dormidos, %d bloqueados, %d estrangulados, %d zombis\n",
+		f->ticks, f->n_procs, f->n_listos, f->n_dormidos, f->n_bloqueados, f->n_estrangulados, f->n_zombis);
+
+	for (i=0; i<n; i++) {
+		d[i]=uso(&ahora[i], n_antes);
+		orden[i]=i;
+	}
+	/* n es pequeño: ordenacion por insercion por uso del procesador */
+	for (i=1; i<n; i++)
+		for (j=i; j>0 && d[orden[j]] > d[orden[j-1]]; j--) {
+			aux=orden[j];
+			orden[j]=orden[j-1];
+			orden[j-1]=aux;
+		}
+
+	printf("  %5s %-16s %-12s %5s %4s %7s %7s %s\n", "ID", "PROGRAMA", "ESTADO", "PADRE",
+		"%CPU", "USR", "SIS", "MUTEX");
+	for (i=0; i<n && i<MAX_LINEAS; i++) {
+		struct info_proc *p=&ahora[orden[i]];
+
+		printf("  %5d %-16s %-12s %5d %4llu %7llu %7llu", p->id, p->prog, estados[p->estado],
+			p->padre, ticks>0 ? d[orden[i]]*100/ticks : 0, p->ticks_usuario, p->ticks_sistema);
+		for (j=0; j<NUM_MUT_PROC; j++)
+			if (p->mutex_ids[j]>=0)
+				printf(" %d", p->mutex_ids[j]);
+		printf("\n");
+	}
+
+	for (i=0; i<n; i++)
+		if (ahora[i].estado!=LISTO && ahora[i].estado!=EJECUCION && ahora[i].estado!=ZOMBI)
+			break;
+	if (i<n) {
+		printf("top: procesos esperando\n");
+		for (i=0; i<n; i++)
+			if (ahora[i].estado!=LISTO && ahora[i].estado!=EJECUCION && ahora[i].estado!=ZOMBI)
+				mostrar_espera(&ahora[i], f->ticks);
+	}
+}
+
+int main(){
+	struct foto_sistema f;
+	unsigned long long t_ant;
+	int m, n, n_antes, i;
+
+	n_antes=foto_procesos(&f, antes, MAX_PROCS_TOP);
+	if (n_antes>MAX_PROCS_TOP)
+		n_antes=MAX_PROCS_TOP;
+	t_ant=f.ticks;
+
+	for (m=0; m<NUM_MUESTRAS; m++) {
+		dormir(1);
+		n=foto_procesos(&f, ahora, MAX_PROCS_TOP);
+		if (n>MAX_PROCS_TOP)
+			n=MAX_PROCS_TOP;
+		mostrar(&f, n, n_antes, f.ticks-t_ant);
+		for (i=0; i<n; i++)
+			antes[i]=ahora[i];
+		n_antes=n;
+		t_ant=f.ticks;
+	}
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * usuario/trabajador_cfs.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que ejecuta un trabajador de prueba_cfs. Recibe
+ * sus parametros por la cola "cfs" y, hasta que se activa la region
+ * compartida "fin", consume procesador sin parar (intensivo) o en
+ * rafagas cortas seguidas de una espera de ESPERA ticks (interactivo),
+ * midiendo el retraso con el que vuelve a ejecutar tras cada espera.
+ * Devuelve sus contadores por la cola "rcfs".
+ */
+
+#include "servicios.h"
+
+#define TANDA 100000	/* iteraciones entre consultas de fin */
+#define ESPERA 3		/* ticks que duerme un interactivo entre rafagas */
+
+struct param_cfs {
+	int interactivo;
+	int nice;
+};
+
+struct res_cfs {
+	int interactivo;
+	int nice;
+	int tandas;			/* trabajo hecho, en tandas de TANDA iteraciones */
+	int despertares;
+	int retraso_total;	/* ticks entre el despertar pedido y el real */
+	int retraso_max;
+};
+
+int main(){
+	struct param_cfs par;
+	struct res_cfs res;
+	struct mensaje msj;
+	volatile int k;
+	volatile int *fin;
+	int cfs, rcfs, shm, t, retraso;
+
+	if ((cfs=abrir_cola("cfs"))<0 || (rcfs=abrir_cola("rcfs"))<0 ||
+		(shm=abrir_memoria_compartida("fin", (void **)&fin))<0) {
+		printf("trabajador_cfs: error abriendo las colas o la region\n");
+		return 0;
+	}
+	msj.datos=&par;
+	msj.tam=sizeof(par);
+	recibir(cfs, &msj, ESPERA_INDEFINIDA);
+
+	if (fijar_nice(par.nice)<0)
+		printf("trabajador_cfs: nice %d fuera de rango\n", par.nice);
+
+	res.interactivo=par.interactivo;
+	res.nice=par.nice;
+	res.tandas=res.despertares=res.retraso_total=res.retraso_max=0;
+	while (!*fin) {
+		for (k=0; k<TANDA; k++);
+		res.tandas++;
+
+		if (par.interactivo) {
+			t=tiempos_proceso(0)+ESPERA;
+			dormir_hasta(t);
+			retraso=tiempos_proceso(0)-t;
+			res.despertares++;
+			res.retraso_total+=retraso;
+			if (retraso > res.retraso_max)
+				res.retraso_max=retraso;
+		}
+	}
+	cerrar_memoria_compartida(shm);
+
+	msj.datos=&res;
+	msj.tam=sizeof(res);
+	msj.prioridad=0;
+	enviar(rcfs, &msj, ESPERA_INDEFINIDA);
+	return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * usuario/vmstat.c
+ *
+ *  Minikernel. Versión 1.0
+ *
+ *  Álvaro López García
+ *
+ */
+
+/*
+ * Programa de usuario que muestra los contadores globales del sistema.
+ * Cada segundo, NUM_MUESTRAS veces, escribe una linea con los procesos
+ * ejecutables, las medias de carga de 1, 5 y 15 segundos, las
+ * interrupciones por segundo de cada vector, los cambios de contexto
+ * por segundo (voluntarios, involuntarios y por fin) y el porcentaje
+ * de ticks en que el procesador ha estado ocioso.
+ */
+
+#include "servicios.h"
+
+#define NUM_MUESTRAS 10
+
+/* Eventos por segundo de un contador en t ticks */
+static unsigned long long por_seg(unsigned long long antes, unsigned long long ahora, unsigned long long t){
+	return t>0 ? (ahora-antes)*TICK/t : 0;
+}
+
+int main(){
+	struct estad_sistema a, e;
+	unsigned long long t;
+	int m;
+
+	estadisticas_sistema(&a);
+	printf("vmstat: %5s %4s %17s %6s %5s %7s %5s %4s %5s %5s %5s %4s\n", "tick", "ejec",
+		"carga 1/5/15", "reloj", "term", "llamsis", "sw", "exc", "vol", "invol", "fin", "%oci");
+	for (m=0; m<NUM_MUESTRAS; m++) {
+		dormir(1);
+		estadisticas_sistema(&e);
+		t=e.ticks-a.ticks;
+		printf("vmstat: %5llu %4d %3u.%02u %3u.%02u %3u.%02u %6llu %5llu %7llu %5llu %4llu %5llu %5llu %5llu %4llu\n",
+			e.ticks, e.ejecutables,
+			e.carga[0]/1000, e.carga[0]%1000/10, e.carga[1]/1000, e.carga[1]%1000/10,
+			e.carga[2]/1000, e.carga[2]%1000/10,
+			por_seg(a.interrupciones[INT_RELOJ], e.interrupciones[INT_RELOJ], t),
+			por_seg(a.interrupciones[INT_TERMINAL], e.interrupciones[INT_TERMINAL], t),
+			por_seg(a.interrupciones[LLAM_SIS], e.interrupciones[LLAM_SIS], t),
+			por_seg(a.interrupciones[INT_SW], e.interrupciones[INT_SW], t),
+			(e.interrupciones[EXC_ARITM]+e.interrupciones[EXC_MEM])-
+				(a.interrupciones[EXC_ARITM]+a.interrupciones[EXC_MEM]),
+			por_seg(a.cambios_voluntarios, e.cambios_voluntarios, t),
+			por_seg(a.cambios_involuntarios, e.cambios_involuntarios, t),
+			por_seg(a.cambios_fin, e.cambios_fin, t),
+			t>0 ? (e.ticks_ociosos-a.ticks_ociosos)*100/t : 0);
+		a=e;
+	}
+	return 0;
+}